@@ -1,57 +1,102 @@
+#include <stdatomic.h>
+
 #include "matrix.h"
 
-matrix_t create_matrix(int rows, int columns) {
-  char memory_given = 1;
-  matrix_t matrix;
+// elementwise operation split into ranges of rows of the same layout
+typedef struct elementwise_job_struct {
+  matrix_binary_kernel_t operator;
+  const double *a;
+  const double *b;
+  double number;
+  double *res;
+  int stride;
+} elementwise_job_t;
+
+// type scan split into ranges of rows; flags are combined from all ranges
+typedef struct type_scan_job_struct {
+  matrix_t *m;
+  atomic_int identity;
+  atomic_int zero;
+  atomic_int nan;
+} type_scan_job_t;
+
+static void binary_rows_task(void *arg, int begin, int end) {
+  const elementwise_job_t *job = (const elementwise_job_t *)arg;
+  size_t offset = (size_t)begin * job->stride;
+
+  job->operator(job->a + offset, job->b + offset, job->res + offset,
+                (size_t)(end - begin) * job->stride);
+}
 
-  matrix.matrix_type = INCORRECT_MATRIX;
-  if (rows > 0 && columns > 0) {
-    matrix.rows = rows;
-    matrix.columns = columns;
-    matrix.matrix = (double **)calloc(matrix.rows, sizeof(double *));
-    if (matrix.matrix) {
-      for (rows--; rows >= 0 && memory_given; rows--) {
-        matrix.matrix[rows] = (double *)calloc(matrix.columns, sizeof(double));
-        if (!matrix.matrix[rows]) memory_given = 0;
+static void scale_rows_task(void *arg, int begin, int end) {
+  const elementwise_job_t *job = (const elementwise_job_t *)arg;
+  size_t offset = (size_t)begin * job->stride;
+
+  matrix_kernels.scale(job->a + offset, job->number, job->res + offset,
+                       (size_t)(end - begin) * job->stride);
+}
+
+static void type_scan_task(void *arg, int begin, int end) {
+  type_scan_job_t *job = (type_scan_job_t *)arg;
+  matrix_t *m = job->m;
+  char identity = 1, zero = 1, nan = 0;
+
+  for (int i = begin; !nan && i < end; i++) {
+    for (int j = 0; !nan && j < m->columns; j++) {
+      if (m->matrix) {
+        identity =
+            identity && ((i == j && fabs(m->matrix[i][j] - 1) < ACCURACY) ||
+                         (i != j && fabs(m->matrix[i][j]) < ACCURACY));
+        zero = zero && fabs(m->matrix[i][j]) < ACCURACY;
+        if (m->matrix[i][j] != m->matrix[i][j]) nan = 1;
+      } else {
+        identity = 0;
+        zero = 0;
       }
-    } else {
-      memory_given = 0;
     }
-    if (memory_given) matrix.matrix_type = ZERO_MATRIX;
-  } else {
-    matrix_error(&matrix);
   }
+  if (!identity) atomic_store(&job->identity, 0);
+  if (!zero) atomic_store(&job->zero, 0);
+  if (nan) atomic_store(&job->nan, 1);
+}
 
-  return matrix;
+// validation policy of the calling thread, see set_matrix_validation()
+static _Thread_local matrix_validation_t validation_policy = VALIDATION_CHECKED;
+
+matrix_t create_matrix(int rows, int columns) {
+  return create_matrix_in(get_matrix_arena(), rows, columns);
 }
 
 void remove_matrix(matrix_t *a) {
   if (a && a->matrix) {
-    for (a->rows--; a->rows >= 0; a->rows--) {
-      if (a->matrix[a->rows]) {
-        free(a->matrix[a->rows]);
-        a->matrix[a->rows] = NULL;
-      }
+    // arena storage is given back all at once with arena_reset()
+    if (!a->in_arena) {
+      matrix_buffer_give(a->data, matrix_storage_size(a->rows, a->columns));
     }
-    free(a->matrix);
+    a->data = NULL;
     a->matrix = NULL;
     a->matrix_type = 0;
+    a->classified = 0;
     a->columns = 0;
     a->rows = 0;
+    a->stride = 0;
+    a->in_arena = 0;
   }
 }
 
+double *matrix_data(matrix_t *a) { return a ? a->data : NULL; }
+
+int matrix_stride(matrix_t *a) { return a ? a->stride : 0; }
+
 int eq_matrix(matrix_t *a, matrix_t *b) {
   char state = 0;
   int equal = SUCCESS;
 
   state = base_check_matrices(a, b);
   if (a && b && state && a->columns == b->columns && a->rows == b->rows) {
-    for (int i = 0; equal && i < a->rows; i++) {
-      for (int j = 0; equal && j < a->columns; j++) {
-        equal = equal && fabs(a->matrix[i][j] - b->matrix[i][j]) < ACCURACY;
-      }
-    }
+    equal = matrix_kernels.compare(a->data, b->data, matrix_size(a), ACCURACY)
+                ? SUCCESS
+                : FAILURE;
   } else {
     equal = FAILURE;
   }
@@ -65,9 +110,10 @@ matrix_t sum_matrix(matrix_t *a, matrix_t *b) {
 
   state = base_check_matrices(a, b);
   if (a && b && state && a->columns == b->columns && a->rows == b->rows) {
-    matrix = create_matrix(a->rows, a->columns);
-    simple_matrix_operations(matrix_value_summ, *a, *b, &matrix);
-    check_matrix_type(&matrix);
+    matrix = allocate_matrix(get_matrix_arena(), a->rows, a->columns);
+    if (matrix.matrix) {
+      simple_matrix_operations(matrix_kernels.add, *a, *b, &matrix);
+    }
   } else {
     matrix_error(&matrix);
   }
@@ -81,9 +127,10 @@ matrix_t sub_matrix(matrix_t *a, matrix_t *b) {
 
   state = base_check_matrices(a, b);
   if (a && b && state && a->columns == b->columns && a->rows == b->rows) {
-    matrix = create_matrix(a->rows, a->columns);
-    simple_matrix_operations(matrix_value_subb, *a, *b, &matrix);
-    check_matrix_type(&matrix);
+    matrix = allocate_matrix(get_matrix_arena(), a->rows, a->columns);
+    if (matrix.matrix) {
+      simple_matrix_operations(matrix_kernels.sub, *a, *b, &matrix);
+    }
   } else {
     matrix_error(&matrix);
   }
@@ -97,13 +144,8 @@ matrix_t mult_number(matrix_t *a, double number) {
 
   state = base_check_matrices(a, NULL);
   if (a && state) {
-    matrix = create_matrix(a->rows, a->columns);
-    for (int i = 0; i < a->rows; i++) {
-      for (int j = 0; j < a->columns; j++) {
-        matrix.matrix[i][j] = a->matrix[i][j] * number;
-      }
-    }
-    check_matrix_type(&matrix);
+    matrix = allocate_matrix(get_matrix_arena(), a->rows, a->columns);
+    if (matrix.matrix) calculate_scaled_matrix(*a, number, &matrix);
   } else {
     matrix_error(&matrix);
   }
@@ -116,13 +158,11 @@ matrix_t mult_matrix(matrix_t *a, matrix_t *b) {
 
   state = base_check_matrices(a, b);
   if (a && b && state && a->columns == b->rows) {
-    matrix = create_matrix(a->rows, b->columns);
-    for (int i = 0; i < matrix.rows; i++) {
-      for (int j = 0; j < matrix.columns; j++) {
-        calculate_multiplied_matrix_element(*a, *b, i, j, &matrix.matrix[i][j]);
-      }
+    matrix = allocate_matrix(get_matrix_arena(), a->rows, b->columns);
+    if (!matrix.matrix || !calculate_matrix_product(*a, *b, &matrix)) {
+      remove_matrix(&matrix);
+      matrix_error(&matrix);
     }
-    check_matrix_type(&matrix);
   } else {
     matrix_error(&matrix);
   }
@@ -130,19 +170,39 @@ matrix_t mult_matrix(matrix_t *a, matrix_t *b) {
   return matrix;
 }
 
+int gemm_matrix(int trans_a, int trans_b, double alpha, matrix_t *a,
+                matrix_t *b, double beta, matrix_t *c) {
+  char state = 0;
+
+  state = base_check_matrices(a, b);
+  // former "c" is an operand unless beta drops it
+  if (c && state && beta != 0.0) check_matrix_status(c, &state);
+  if (a && b && state) {
+    int m = trans_a ? a->columns : a->rows, k = trans_a ? a->rows : a->columns;
+    int n = trans_b ? b->rows : b->columns;
+    state = k == (trans_b ? b->columns : b->rows) && check_output(c, m, n) &&
+            c->data != a->data && c->data != b->data;
+    if (state) {
+      // transposed operands are read with swapped strides
+      int rsa = trans_a ? 1 : a->stride, csa = trans_a ? a->stride : 1;
+      int rsb = trans_b ? 1 : b->stride, csb = trans_b ? b->stride : 1;
+      state = gemm_blocked(m, n, k, alpha, a->data, rsa, csa, b->data, rsb,
+                           csb, beta, c->data, c->stride);
+      set_result_type(c, UNKNOWN_MATRIX);
+    }
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
 matrix_t transpose(matrix_t *a) {
   matrix_t matrix;
   char state = 0;
 
   state = base_check_matrices(a, NULL);
   if (a && state) {
-    matrix = create_matrix(a->columns, a->rows);
-    for (int i = 0; i < matrix.rows; i++) {
-      for (int j = 0; j < matrix.columns; j++) {
-        matrix.matrix[i][j] = a->matrix[j][i];
-      }
-    }
-    check_matrix_type(&matrix);
+    matrix = allocate_matrix(get_matrix_arena(), a->columns, a->rows);
+    if (matrix.matrix) calculate_transposed_matrix(*a, &matrix);
   } else {
     matrix_error(&matrix);
   }
@@ -155,19 +215,12 @@ matrix_t calc_complements(matrix_t *a) {
   char state = 0;
 
   state = base_check_matrices(a, NULL);
-  if (a && state) {
-    matrix = create_matrix(a->rows, a->columns);
-    if (a->columns > 1 && a->rows > 1) {
-      for (int i = 0; i < a->rows; i++) {
-        for (int j = 0; j < a->columns; j++) {
-          matrix.matrix[i][j] =
-              algebraic_addition(*a, i, j) * (-1 + !((i + j) % 2) * 2);
-        }
-      }
-    } else {
-      matrix.matrix[0][0] = a->matrix[0][0];
+  if (a && state && a->rows == a->columns) {
+    matrix = allocate_matrix(get_matrix_arena(), a->rows, a->columns);
+    if (!matrix.matrix || !calculate_complements(*a, &matrix)) {
+      remove_matrix(&matrix);
+      matrix_error(&matrix);
     }
-    check_matrix_type(&matrix);
   } else {
     matrix_error(&matrix);
   }
@@ -198,21 +251,14 @@ double determinant(matrix_t *a) {
 }
 
 matrix_t inverse_matrix(matrix_t *a) {
-  double det = 0.0, inverse_determinant = 0.0;
-  matrix_t matrix, buffer;
+  matrix_t matrix;
   char state = 0;
 
   state = base_check_matrices(a, NULL);
   if (a && state && a->rows == a->columns) {
-    det = determinant(a);
-    if (fabs(det) >= ACCURACY) {
-      inverse_determinant = 1 / det;
-      matrix = transpose(a);
-      buffer = calc_complements(&matrix);
+    matrix = allocate_matrix(get_matrix_arena(), a->rows, a->columns);
+    if (!matrix.matrix || !calculate_LU_inverse(*a, &matrix)) {
       remove_matrix(&matrix);
-      matrix = mult_number(&buffer, inverse_determinant);
-      remove_matrix(&buffer);
-    } else {
       matrix_error(&matrix);
     }
   } else {
@@ -222,16 +268,195 @@ matrix_t inverse_matrix(matrix_t *a) {
   return matrix;
 }
 
-double algebraic_addition(matrix_t a, int row, int col) {
-  double returnable = 0.0;
-  matrix_t minor;
+int sum_matrix_into(matrix_t *a, matrix_t *b, matrix_t *out) {
+  char state = 0;
+
+  state = base_check_matrices(a, b);
+  if (a && b && state && a->columns == b->columns && a->rows == b->rows &&
+      check_output(out, a->rows, a->columns)) {
+    simple_matrix_operations(matrix_kernels.add, *a, *b, out);
+  } else {
+    state = 0;
+  }
 
-  minor = create_matrix(a.rows - 1, a.columns - 1);
-  make_matrix_minor(a, row, col, &minor);
-  returnable = determinant(&minor);
-  remove_matrix(&minor);
+  return state ? SUCCESS : FAILURE;
+}
 
-  return returnable;
+int sub_matrix_into(matrix_t *a, matrix_t *b, matrix_t *out) {
+  char state = 0;
+
+  state = base_check_matrices(a, b);
+  if (a && b && state && a->columns == b->columns && a->rows == b->rows &&
+      check_output(out, a->rows, a->columns)) {
+    simple_matrix_operations(matrix_kernels.sub, *a, *b, out);
+  } else {
+    state = 0;
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+int mult_number_into(matrix_t *a, double number, matrix_t *out) {
+  char state = 0;
+
+  state = base_check_matrices(a, NULL);
+  if (a && state && check_output(out, a->rows, a->columns)) {
+    calculate_scaled_matrix(*a, number, out);
+  } else {
+    state = 0;
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+int mult_matrix_into(matrix_t *a, matrix_t *b, matrix_t *out) {
+  char state = 0;
+
+  state = base_check_matrices(a, b);
+  // product is accumulated in "out", so it must not share storage with operands
+  if (a && b && state && a->columns == b->rows &&
+      check_output(out, a->rows, b->columns) && out->data != a->data &&
+      out->data != b->data) {
+    state = calculate_matrix_product(*a, *b, out);
+  } else {
+    state = 0;
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+int transpose_into(matrix_t *a, matrix_t *out) {
+  char state = 0;
+
+  state = base_check_matrices(a, NULL);
+  // in place only for square matrices: other shapes change row layout
+  if (a && state && check_output(out, a->columns, a->rows) &&
+      (out->data != a->data || a->rows == a->columns)) {
+    calculate_transposed_matrix(*a, out);
+  } else {
+    state = 0;
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+int calc_complements_into(matrix_t *a, matrix_t *out) {
+  char state = 0;
+
+  state = base_check_matrices(a, NULL);
+  if (a && state && a->rows == a->columns &&
+      check_output(out, a->rows, a->columns)) {
+    state = calculate_complements(*a, out);
+  } else {
+    state = 0;
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+int inverse_matrix_into(matrix_t *a, matrix_t *out) {
+  char state = 0;
+
+  state = base_check_matrices(a, NULL);
+  if (a && state && a->rows == a->columns &&
+      check_output(out, a->rows, a->columns)) {
+    state = calculate_LU_inverse(*a, out);
+  } else {
+    state = 0;
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+int sum_matrix_inplace(matrix_t *a, matrix_t *b) {
+  return sum_matrix_into(a, b, a);
+}
+
+int sub_matrix_inplace(matrix_t *a, matrix_t *b) {
+  return sub_matrix_into(a, b, a);
+}
+
+int mult_number_inplace(matrix_t *a, double number) {
+  return mult_number_into(a, number, a);
+}
+
+void calculate_scaled_matrix(matrix_t a, double number, matrix_t *res) {
+  elementwise_job_t job = {NULL, a.data, NULL, number, res->data, a.stride};
+  // zero factor still multiplies: infinite elements pass validation and
+  // give NaN; only zero and identity operands are known to be finite
+  char finite = has_type(a, ZERO_MATRIX) || has_type(a, IDENTITY_MATRIX);
+
+  parallel_for(a.rows, elementwise_grain(a.stride), scale_rows_task, &job);
+  if (number == 0.0 && finite) {
+    set_result_type(res, ZERO_MATRIX);
+  } else if (number == 1.0 && has_type(a, IDENTITY_MATRIX)) {
+    set_result_type(res, IDENTITY_MATRIX);
+  } else {
+    set_result_type(res, UNKNOWN_MATRIX);
+  }
+}
+
+char calculate_matrix_product(matrix_t a, matrix_t b, matrix_t *res) {
+  char state = 0;
+
+  state = gemm_product(a.rows, b.columns, a.columns, a.data, a.stride, b.data,
+                       b.stride, res->data, res->stride);
+  set_result_type(res, has_type(a, IDENTITY_MATRIX) &&
+                               has_type(b, IDENTITY_MATRIX)
+                           ? IDENTITY_MATRIX
+                           : UNKNOWN_MATRIX);
+
+  return state;
+}
+
+void calculate_transposed_matrix(matrix_t a, matrix_t *res) {
+  if (res->data == a.data) {
+    transpose_square(res->data, res->rows, res->stride);
+  } else {
+    transpose_block(a.data, a.stride, res->data, res->stride, a.rows,
+                    a.columns);
+  }
+  set_result_type(res, has_type(a, IDENTITY_MATRIX) ? IDENTITY_MATRIX
+                                                    : UNKNOWN_MATRIX);
+}
+
+char calculate_complements(matrix_t a, matrix_t *res) {
+  double minors[3][3] = {{0}};
+  char state = 1;
+
+  if (a.rows == 1) {
+    res->matrix[0][0] = a.matrix[0][0];
+  } else if (a.rows == 2) {
+    minors[0][0] = a.matrix[1][1];
+    minors[0][1] = -a.matrix[1][0];
+    minors[1][0] = -a.matrix[0][1];
+    minors[1][1] = a.matrix[0][0];
+  } else if (a.rows == 3) {
+    // cyclic indices give cofactor sign, so no minors are allocated
+    for (int i = 0; i < 3; i++) {
+      int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+      for (int j = 0; j < 3; j++) {
+        int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+        minors[i][j] = a.matrix[i1][j1] * a.matrix[i2][j2] -
+                       a.matrix[i1][j2] * a.matrix[i2][j1];
+      }
+    }
+  } else {
+    state = calculate_LU_complements(a, res);
+  }
+  // small sizes go through buffer, so "res" may be the same matrix as "a"
+  if (a.rows > 1 && a.rows <= 3) {
+    for (int i = 0; i < a.rows; i++) {
+      memcpy(res->matrix[i], minors[i], sizeof(double) * a.columns);
+    }
+  }
+  set_result_type(res, UNKNOWN_MATRIX);
+
+  return state;
+}
+
+double algebraic_addition(matrix_t a, int row, int col) {
+  return calculate_view_determinant(view_minor(&a, row, col));
 }
 
 void make_matrix_minor(matrix_t a, int row, int col, matrix_t *minor) {
@@ -262,27 +487,7 @@ double calculate_3d_determinant(matrix_t a) {
 }
 
 double calculate_Gauss_determinant(matrix_t a) {
-  double returnable = 0.0;
-  int row_constrain = 0;
-  char det_zero = 0;
-  matrix_t b;
-
-  b = create_matrix(a.rows, a.columns);
-  copy_matrix(a, &b);
-  for (int i = 0; !det_zero && i < b.columns; i++) {
-    for (int j = b.rows - 1; !det_zero && j > row_constrain; j--) {
-      process_the_row(&b, j, i, &det_zero);
-    }
-    row_constrain += 1;
-  }
-  if (!det_zero) {
-    returnable = multiply_diagonal(b);
-  } else {
-    returnable = 0.0;
-  }
-  remove_matrix(&b);
-
-  return returnable;
+  return calculate_Gauss_determinant_view(view_matrix(&a));
 }
 
 double multiply_diagonal(matrix_t a) {
@@ -293,91 +498,87 @@ double multiply_diagonal(matrix_t a) {
   return returnable;
 }
 
-void process_the_row(matrix_t *a, const int row, int col, char *zero) {
-  double prew_row_n = a->matrix[row - 1][col];
-  double row_n = a->matrix[row][col] * -1;
-
-  for (int k = col; k < a->columns && !*zero; k++) {
-    if (prew_row_n != 0) {
-      a->matrix[row][k] =
-          (row_n / prew_row_n) * a->matrix[row - 1][k] + a->matrix[row][k];
-    } else {
-      scan_column_to_find_nonzero_num(a, row - 1, k, zero);
-      prew_row_n = a->matrix[row - 1][col];
-      a->matrix[row][k] =
-          (row_n / prew_row_n) * a->matrix[row - 1][k] + a->matrix[row][k];
-    }
-  }
-  a->matrix[row][col] = 0;
+void matrix_error(matrix_t *m) {
+  m->matrix_type = INCORRECT_MATRIX;
+  m->matrix = NULL;
+  m->data = NULL;
+  m->columns = 0;
+  m->rows = 0;
+  m->stride = 0;
+  m->validated = 0;
+  m->in_arena = 0;
+  m->classified = 0;
 }
 
-void scan_column_to_find_nonzero_num(matrix_t *a, const int row, const int col,
-                                     char *zero) {
-  char found = 0;
+size_t matrix_data_size(int rows, int columns) {
+  size_t size = (size_t)rows * (size_t)columns * sizeof(double);
 
-  for (int i = a->rows - 1; !found && i >= 0; i--) {
-    if (fabs(a->matrix[i][col]) >= ACCURACY) {
-      this_row_plus_that_row(a, i, row);
-      found = 1;
-    } else if (i == 0) {
-      *zero = 1;
-    }
-  }
+  return (size + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
 }
 
-void this_row_plus_that_row(matrix_t *a, const int row_num,
-                            const int row_zero) {
-  for (int i = 0; i < a->columns; i++) {
-    a->matrix[row_zero][i] += a->matrix[row_num][i];
-  }
+size_t matrix_storage_size(int rows, int columns) {
+  return matrix_data_size(rows, columns) + matrix_rows_size(rows);
 }
 
-void matrix_error(matrix_t *m) {
-  m->matrix_type = INCORRECT_MATRIX;
-  m->matrix = NULL;
-  m->columns = 0;
-  m->rows = 0;
+size_t matrix_rows_size(int rows) {
+  size_t size = (size_t)rows * sizeof(double *);
+
+  return (size + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
 }
 
-void calculate_multiplied_matrix_element(matrix_t a, matrix_t b, int i, int j,
-                                         double *res) {
-  for (int k = 0; k < a.columns; k++) {
-    *res += a.matrix[i][k] * b.matrix[k][j];
+void bind_matrix_rows(matrix_t *m) {
+  for (int i = 0; i < m->rows; i++) {
+    m->matrix[i] = m->data + (size_t)i * m->stride;
   }
 }
 
-void simple_matrix_operations(double operator(double, double), matrix_t a,
+void simple_matrix_operations(matrix_binary_kernel_t kernel, matrix_t a,
                               matrix_t b, matrix_t *res) {
-  for (int i = 0; i < a.rows; i++) {
-    for (int j = 0; j < a.columns; j++) {
-      res->matrix[i][j] = operator(a.matrix[i][j], b.matrix[i][j]);
-    }
-  }
-  check_matrix_type(res);
+  elementwise_job_t job = {kernel, a.data, b.data, 0.0, res->data, a.stride};
+
+  parallel_for(a.rows, elementwise_grain(a.stride), binary_rows_task, &job);
+  set_result_type(res, UNKNOWN_MATRIX);
 }
 
-double matrix_value_summ(double a, double b) { return a + b; }
+char check_output(matrix_t *out, int rows, int columns) {
+  char state = out && out->matrix && out->data && out->rows == rows &&
+               out->columns == columns;
 
-double matrix_value_subb(double a, double b) { return a - b; }
+  // results are written over, so cached validation does not hold anymore
+  if (state) out->validated = 0;
 
-void check_matrix_type(matrix_t *m) {
-  char identity = 1, zero = 1, nan = 0;
+  return state;
+}
 
-  for (int i = 0; !nan && i < m->rows; i++) {
-    for (int j = 0; !nan && j < m->columns; j++) {
-      if (m->matrix) {
-        identity =
-            identity && ((i == j && fabs(m->matrix[i][j] - 1) < ACCURACY) ||
-                         (i != j && fabs(m->matrix[i][j]) < ACCURACY));
-        zero = zero && fabs(m->matrix[i][j]) < ACCURACY;
-        if (m->matrix[i][j] != m->matrix[i][j]) nan = 1;
-      } else {
-        identity = 0;
-        zero = 0;
-      }
+int elementwise_grain(int columns) {
+  return MATRIX_PARALLEL_GRAIN / (columns > 0 ? columns : 1) + 1;
+}
+
+size_t matrix_size(matrix_t *m) { return (size_t)m->rows * m->stride; }
+
+matrix_type_t get_matrix_type(matrix_t *m) {
+  matrix_type_t returnable = INCORRECT_MATRIX;
+
+  if (m) {
+    if (m->matrix_type == UNKNOWN_MATRIX ||
+        (!m->classified && m->matrix_type != INCORRECT_MATRIX)) {
+      check_matrix_type(m);
     }
+    returnable = m->matrix_type;
   }
 
+  return returnable;
+}
+
+void check_matrix_type(matrix_t *m) {
+  type_scan_job_t job = {m, 1, 1, 0};
+  char identity = 0, zero = 0, nan = 0;
+
+  parallel_for(m->rows, elementwise_grain(m->columns), type_scan_task, &job);
+  identity = atomic_load(&job.identity);
+  zero = atomic_load(&job.zero);
+  nan = atomic_load(&job.nan);
+
   if (!nan && identity && m->rows == m->columns)
     m->matrix_type = IDENTITY_MATRIX;
   else if (!nan && zero)
@@ -386,6 +587,16 @@ void check_matrix_type(matrix_t *m) {
     m->matrix_type = CORRECT_MATRIX;
   else
     m->matrix_type = INCORRECT_MATRIX;
+  m->classified = 1;
+}
+
+char has_type(matrix_t a, matrix_type_t type) {
+  return a.classified && a.matrix_type == type;
+}
+
+void set_result_type(matrix_t *res, matrix_type_t type) {
+  res->matrix_type = type;
+  res->classified = type != UNKNOWN_MATRIX;
 }
 
 char base_check_matrices(matrix_t *a, matrix_t *b) {
@@ -402,15 +613,40 @@ char base_check_matrices(matrix_t *a, matrix_t *b) {
 }
 
 void check_matrix_status(matrix_t *a, char *state) {
+  matrix_validation_t policy = get_matrix_validation();
+
   *state = a->columns > 0 && a->rows > 0 && a->matrix != NULL &&
-           a->matrix_type != INCORRECT_MATRIX;
-  for (int i = a->rows - 1; *state && i >= 0; i--) {
-    *state = *state && a->matrix[i];
-    if (*state) {
-      for (int j = 0; j < a->columns; j++) {
-        *state = *state && a->matrix[i][j] == a->matrix[i][j];
-      }
-    }
+           a->data != NULL && a->matrix_type != INCORRECT_MATRIX;
+#ifdef NDEBUG
+  if (policy == VALIDATION_DEBUG) policy = VALIDATION_TRUSTED;
+#endif
+  if (*state && policy != VALIDATION_TRUSTED &&
+      !(policy == VALIDATION_CACHED && a->validated)) {
+    *state = !has_nan(a->data, matrix_size(a));
+    a->validated = policy == VALIDATION_CACHED && *state;
+  }
+}
+
+char has_nan(const double *data, size_t n) {
+  char nan = 0;
+
+  for (size_t i = 0; i < n; i++) nan |= data[i] != data[i];
+
+  return nan;
+}
+
+void set_matrix_validation(matrix_validation_t policy) {
+  validation_policy = policy;
+}
+
+matrix_validation_t get_matrix_validation(void) { return validation_policy; }
+
+void touch_matrix(matrix_t *m) {
+  if (m) {
+    m->validated = 0;
+    m->classified = 0;
+    // matrices without storage stay INCORRECT_MATRIX
+    if (m->matrix) m->matrix_type = UNKNOWN_MATRIX;
   }
 }
 
@@ -8,12 +8,22 @@
 // accuracy to double values comparison
 #define ACCURACY 0.0000001
 
+// alignment in bytes of matrix element storage
+#define MATRIX_ALIGNMENT 64
+
+// elements one thread handles at least, smaller work is not split
+#define MATRIX_PARALLEL_GRAIN 65536
+
+// matrices of a batch processed by one vector operation
+#define MATRIX_BATCH_LANES 8
+
 // matrix states
 typedef enum {
   CORRECT_MATRIX = 0,
   INCORRECT_MATRIX = 1,
   IDENTITY_MATRIX = 2,
-  ZERO_MATRIX = 3
+  ZERO_MATRIX = 3,
+  UNKNOWN_MATRIX = 4  // not classified yet, read it with get_matrix_type()
 } matrix_type_t;
 
 // matrix struct
@@ -22,12 +32,131 @@ typedef struct matrix_struct {
   int rows;
   int columns;
   matrix_type_t matrix_type;
+  double *data;     // row-major MATRIX_ALIGNMENT-aligned elements storage
+  int stride;       // leading dimension: distance in elements between rows
+  char validated;   // NaN scan passed and matrix is not touched since
+  char in_arena;    // storage belongs to arena and is not freed by itself
+  char classified;  // matrix_type was derived by library, not stamped
 } matrix_t;
 
+// read-only window into matrix storage, nothing is copied
+typedef struct matrix_view_struct {
+  const double *origin;  // element (0, 0) of the underlying block
+  int rows;              // rows of the view, skipped one excluded
+  int columns;           // columns of the view, skipped one excluded
+  int stride;            // distance in elements between underlying rows
+  int skip_row;          // row of the block left out, -1 for none
+  int skip_column;       // column of the block left out, -1 for none
+  char transposed;       // element (i, j) is read from block element (j, i)
+} matrix_view_t;
+
+// operands validation policies
+typedef enum {
+  VALIDATION_CHECKED = 0,  // every call scans all elements for NaN
+  VALIDATION_CACHED = 1,   // scan result is kept until touch_matrix()
+  VALIDATION_DEBUG = 2,    // checked unless library is built with NDEBUG
+  VALIDATION_TRUSTED = 3   // only O(1) shape and state checks
+} matrix_validation_t;
+
+// matrix product algorithms, see set_matrix_product()
+typedef enum {
+  PRODUCT_CLASSIC = 0,  // blocked GEMM of any size
+  PRODUCT_AUTO = 1      // Strassen-Winograd levels while all sizes pass cutoff
+} matrix_product_t;
+
+// LU factorization with partial pivoting: P * A = L * U
+typedef struct lu_struct {
+  matrix_t lu;  // unit lower L strictly below diagonal, U on and above it
+  int *pivots;  // row i of P * A is row pivots[i] of A
+  int sign;     // permutation parity: 1 or -1
+} lu_t;
+
 // defines
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// elementwise kernels over "n" consecutive doubles
+typedef void (*matrix_binary_kernel_t)(const double *a, const double *b,
+                                       double *res, size_t n);
+
+// kernel set selected at load time according to CPU features
+typedef struct matrix_kernels_struct {
+  const char *name;  // "scalar", "avx2" or "avx512"
+  matrix_binary_kernel_t add;
+  matrix_binary_kernel_t sub;
+  void (*scale)(const double *a, double number, double *res, size_t n);
+  void (*axpy)(double alpha, const double *x, double *y, size_t n);
+  int (*compare)(const double *a, const double *b, size_t n, double accuracy);
+} matrix_kernels_t;
+
+extern matrix_kernels_t matrix_kernels;
+
+// body of parallel loop: handles iterations [begin, end)
+typedef void (*matrix_task_t)(void *arg, int begin, int end);
+
+// library heap traffic since start of the program
+typedef struct matrix_alloc_stats_struct {
+  size_t allocations;  // buffers taken from the system allocator
+  size_t bytes;        // total size of those buffers
+  size_t frees;        // buffers given back
+} matrix_alloc_stats_t;
+
+// buffer cache of the calling thread, see set_matrix_cache_limit()
+typedef struct matrix_cache_stats_struct {
+  size_t hits;     // matrices created from cached buffers
+  size_t misses;   // matrices created from the heap while cache was enabled
+  size_t buffers;  // buffers held by cache now
+  size_t bytes;    // total size of those buffers
+} matrix_cache_stats_t;
+
+// block of arena memory, MATRIX_ALIGNMENT-aligned storage follows it
+typedef struct matrix_arena_chunk_struct {
+  struct matrix_arena_chunk_struct *previous;
+  size_t size;  // storage bytes
+  size_t used;  // storage bytes handed out
+} matrix_arena_chunk_t;
+
+// bump allocator: everything taken after a mark is released at once
+typedef struct matrix_arena_struct {
+  matrix_arena_chunk_t *chunk;  // current chunk, older ones are chained
+  matrix_arena_chunk_t *spare;  // released chunk kept for reuse
+} matrix_arena_t;
+
+// arena position returned to by arena_reset()
+typedef struct matrix_arena_mark_struct {
+  matrix_arena_chunk_t *chunk;
+  size_t used;
+} matrix_arena_mark_t;
+
+// fixed-size matrices held by value, row-major, without heap storage
+typedef struct mat2_struct {
+  double m[2][2];
+} mat2_t;
+
+typedef struct mat3_struct {
+  double m[3][3];
+} mat3_t;
+
+typedef struct mat4_struct {
+  double m[4][4];
+} mat4_t;
+
+// "count" matrices of one shape in structure-of-arrays layout: element (i, j)
+// of matrix k is data[(i * columns + j) * stride + k], so one SIMD lane
+// holds one matrix; lanes from "count" to "stride" are padding
+typedef struct matrix_batch_struct {
+  double *data;
+  int count;
+  int rows;
+  int columns;
+  int stride;  // count rounded up to MATRIX_BATCH_LANES
+} matrix_batch_t;
 
 /**
  * @brief Creates matrix with "rows" rows and "columns" columns which both
@@ -41,12 +170,42 @@ typedef struct matrix_struct {
 matrix_t create_matrix(int rows, int columns);
 
 /**
- * @brief Removes matrix
+ * @brief Creates matrix like create_matrix() with storage taken from "arena".
+ * Such matrix is released by arena_reset() or remove_arena(), remove_matrix()
+ * only clears it. NULL "arena" takes storage from the heap
+ *
+ * @param arena matrix_arena_t pointer type
+ * @param rows int type
+ * @param columns int type
+ * @return matrix_t
+ */
+matrix_t create_matrix_in(matrix_arena_t *arena, int rows, int columns);
+
+/**
+ * @brief Removes matrix. Elements and row pointers live in one memory block,
+ * so it is released with a single free()
  *
  * @param a matrix_t type
  */
 void remove_matrix(matrix_t *a);
 
+/**
+ * @brief Returns raw elements storage of matrix "a": row-major, aligned to
+ * MATRIX_ALIGNMENT bytes, element (i, j) placed at data[i * stride + j]
+ *
+ * @param a matrix_t pointer type
+ * @return double pointer
+ */
+double *matrix_data(matrix_t *a);
+
+/**
+ * @brief Returns leading dimension of matrix "a" raw storage
+ *
+ * @param a matrix_t pointer type
+ * @return int
+ */
+int matrix_stride(matrix_t *a);
+
 /**
  * @brief Compares matrices and return values defined at the library as SUCCESS
  * or FAILURE
@@ -85,7 +244,9 @@ matrix_t sub_matrix(matrix_t *a, matrix_t *b);
 matrix_t mult_number(matrix_t *a, double number);
 
 /**
- * @brief Multiplies two matrices with sizes m*k and k*m
+ * @brief Multiplies two matrices with sizes m*k and k*m. Uses classic
+ * product with elementwise bounded rounding unless PRODUCT_AUTO is set by
+ * set_matrix_product(), see there for its accuracy trade-off
  *
  * @param a matrix_t pointer type
  * @param b matrix_t pointer type
@@ -93,6 +254,25 @@ matrix_t mult_number(matrix_t *a, double number);
  */
 matrix_t mult_matrix(matrix_t *a, matrix_t *b);
 
+/**
+ * @brief Calculates C = alpha * op(A) * op(B) + beta * C in place of "c" in
+ * one pass, where op(X) is X^T if its "trans" flag is nonzero and X otherwise.
+ * No intermediate matrices are created. "c" must have op(A) rows and op(B)
+ * columns and must not share storage with "a" or "b". Zero "beta" ignores
+ * former contents of "c"
+ *
+ * @param trans_a int type
+ * @param trans_b int type
+ * @param alpha double type
+ * @param a matrix_t pointer type
+ * @param b matrix_t pointer type
+ * @param beta double type
+ * @param c matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int gemm_matrix(int trans_a, int trans_b, double alpha, matrix_t *a,
+                matrix_t *b, double beta, matrix_t *c);
+
 /**
  * @brief Transposes matrix
  *
@@ -125,6 +305,231 @@ double determinant(matrix_t *a);
  */
 matrix_t inverse_matrix(matrix_t *a);
 
+/**
+ * @brief Summs matrices into caller-provided matrix "out" of the same size
+ * without heap allocations. "out" may be "a" or "b"
+ *
+ * @param a matrix_t pointer type
+ * @param b matrix_t pointer type
+ * @param out matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int sum_matrix_into(matrix_t *a, matrix_t *b, matrix_t *out);
+
+/**
+ * @brief Substracts matrices into caller-provided matrix "out" of the same
+ * size without heap allocations. "out" may be "a" or "b"
+ *
+ * @param a matrix_t pointer type
+ * @param b matrix_t pointer type
+ * @param out matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int sub_matrix_into(matrix_t *a, matrix_t *b, matrix_t *out);
+
+/**
+ * @brief Multiplies every matrix element by "number" value into
+ * caller-provided matrix "out" of the same size. "out" may be "a"
+ *
+ * @param a matrix_t pointer type
+ * @param number double type
+ * @param out matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int mult_number_into(matrix_t *a, double number, matrix_t *out);
+
+/**
+ * @brief Multiplies matrices with sizes m*k and k*n into caller-provided m*n
+ * matrix "out", which must not share storage with "a" or "b"
+ *
+ * @param a matrix_t pointer type
+ * @param b matrix_t pointer type
+ * @param out matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int mult_matrix_into(matrix_t *a, matrix_t *b, matrix_t *out);
+
+/**
+ * @brief Transposes m*n matrix "a" into caller-provided n*m matrix "out".
+ * Square matrix may be transposed in place with "out" being "a"
+ *
+ * @param a matrix_t pointer type
+ * @param out matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int transpose_into(matrix_t *a, matrix_t *out);
+
+/**
+ * @brief Calculates algebraic additions matrix of matrix "a" into
+ * caller-provided matrix "out" of the same size. "out" may be "a". Sizes
+ * above 3 still take one scratch buffer for LU factorization
+ *
+ * @param a matrix_t pointer type
+ * @param out matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int calc_complements_into(matrix_t *a, matrix_t *out);
+
+/**
+ * @brief Calculates inverse matrix of matrix "a" into caller-provided matrix
+ * "out" of the same size. "out" may be "a" and is left untouched if "a" is
+ * singular. Takes one scratch buffer for LU factorization
+ *
+ * @param a matrix_t pointer type
+ * @param out matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int inverse_matrix_into(matrix_t *a, matrix_t *out);
+
+/**
+ * @brief Adds matrix "b" to matrix "a" in place: a += b
+ *
+ * @param a matrix_t pointer type
+ * @param b matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int sum_matrix_inplace(matrix_t *a, matrix_t *b);
+
+/**
+ * @brief Substracts matrix "b" from matrix "a" in place: a -= b
+ *
+ * @param a matrix_t pointer type
+ * @param b matrix_t pointer type
+ * @return int SUCCESS/FAILURE
+ */
+int sub_matrix_inplace(matrix_t *a, matrix_t *b);
+
+/**
+ * @brief Multiplies every element of matrix "a" by "number" in place: a *= k
+ *
+ * @param a matrix_t pointer type
+ * @param number double type
+ * @return int SUCCESS/FAILURE
+ */
+int mult_number_inplace(matrix_t *a, double number);
+
+/**
+ * @brief Returns view of whole matrix "a". Views borrow storage: they are
+ * valid until matrix is removed and need no removing themselves. In case of
+ * error returns view with NULL origin
+ *
+ * @param a matrix_t pointer type
+ * @return matrix_view_t
+ */
+matrix_view_t view_matrix(matrix_t *a);
+
+/**
+ * @brief Returns view of "rows" * "columns" block of matrix "a" starting at
+ * element ("row", "column")
+ *
+ * @param a matrix_t pointer type
+ * @param row int type
+ * @param column int type
+ * @param rows int type
+ * @param columns int type
+ * @return matrix_view_t
+ */
+matrix_view_t view_submatrix(matrix_t *a, int row, int column, int rows,
+                             int columns);
+
+/**
+ * @brief Returns view of matrix "a" without row "row" and column "column"
+ *
+ * @param a matrix_t pointer type
+ * @param row int type
+ * @param column int type
+ * @return matrix_view_t
+ */
+matrix_view_t view_minor(matrix_t *a, int row, int column);
+
+/**
+ * @brief Returns transposed view of view "a" without moving any element.
+ * Operations read it with swapped strides
+ *
+ * @param a matrix_view_t type
+ * @return matrix_view_t
+ */
+matrix_view_t view_transposed(matrix_view_t a);
+
+/**
+ * @brief Compares views like eq_matrix()
+ *
+ * @param a matrix_view_t type
+ * @param b matrix_view_t type
+ * @return int SUCCESS/FAILURE
+ */
+int eq_matrix_view(matrix_view_t a, matrix_view_t b);
+
+/**
+ * @brief Calculates determinant of square view "a"
+ *
+ * @param a matrix_view_t type
+ * @return double or NAN in case of error
+ */
+double determinant_view(matrix_view_t a);
+
+/**
+ * @brief Multiplies views with sizes m*k and k*n and returns new m*n matrix.
+ * Submatrix views go to the product directly, minor views are packed first
+ *
+ * @param a matrix_view_t type
+ * @param b matrix_view_t type
+ * @return matrix_t
+ */
+matrix_t mult_matrix_view(matrix_view_t a, matrix_view_t b);
+
+/**
+ * @brief Transposes view "a" into new matrix
+ *
+ * @param a matrix_view_t type
+ * @return matrix_t
+ */
+matrix_t transpose_view(matrix_view_t a);
+
+/**
+ * @brief Factorizes square matrix "a" as P * A = L * U with partial pivoting.
+ * One factorization can be reused for determinant, solving and inversion. In
+ * case of error returns lu_t with INCORRECT_MATRIX "lu" and NULL pivots
+ *
+ * @param a matrix_t pointer type
+ * @return lu_t
+ */
+lu_t lu_decompose(matrix_t *a);
+
+/**
+ * @brief Removes LU factorization
+ *
+ * @param lu lu_t pointer type
+ */
+void remove_lu(lu_t *lu);
+
+/**
+ * @brief Calculates determinant from LU factorization
+ *
+ * @param lu lu_t pointer type
+ * @return double
+ */
+double lu_determinant(lu_t *lu);
+
+/**
+ * @brief Solves A * X = B for X with LU factorization of A. Returns
+ * INCORRECT_MATRIX if A is singular
+ *
+ * @param lu lu_t pointer type
+ * @param b matrix_t pointer type
+ * @return matrix_t
+ */
+matrix_t lu_solve(lu_t *lu, matrix_t *b);
+
+/**
+ * @brief Solves A * X = B for X
+ *
+ * @param a matrix_t pointer type
+ * @param b matrix_t pointer type
+ * @return matrix_t
+ */
+matrix_t solve_matrix(matrix_t *a, matrix_t *b);
+
 /**
  * @brief Calculates 2-dimentional matrix determinant. Used in determinant()
  * function
@@ -144,8 +549,8 @@ double calculate_2d_determinant(matrix_t a);
 double calculate_3d_determinant(matrix_t a);
 
 /**
- * @brief Calculates n-dimentional matrix determinant by Gauss method. Used in
- * determinant() function
+ * @brief Calculates n-dimentional matrix determinant by Gauss method with
+ * partial pivoting (blocked LU factorization). Used in determinant() function
  *
  * @param a matrix_t type
  * @return double
@@ -163,6 +568,399 @@ double calculate_Gauss_determinant(matrix_t a);
  */
 char base_check_matrices(matrix_t *a, matrix_t *b);
 
+/**
+ * @brief Returns matrix type. Operations leave their result as
+ * UNKNOWN_MATRIX unless the type follows from operands, so classification
+ * pass over elements runs only here, once, on first read. Types stamped by
+ * create_matrix() or by the caller are classified again as well
+ *
+ * @param m matrix_t pointer type
+ * @return matrix_type_t
+ */
+matrix_type_t get_matrix_type(matrix_t *m);
+
+/**
+ * @brief Sets operands validation policy of the calling thread. Default
+ * VALIDATION_CHECKED scans every operand for NaN on every call. With
+ * VALIDATION_CACHED scan passes once per matrix: call touch_matrix() after
+ * writing elements directly. VALIDATION_TRUSTED skips the scans
+ *
+ * @param policy matrix_validation_t type
+ */
+void set_matrix_validation(matrix_validation_t policy);
+
+/**
+ * @brief Returns operands validation policy of the calling thread
+ *
+ * @return matrix_validation_t
+ */
+matrix_validation_t get_matrix_validation(void);
+
+/**
+ * @brief Drops cached validation and type of matrix "m" after its elements
+ * were changed outside of the library. Results take IDENTITY_MATRIX or
+ * ZERO_MATRIX from operand types the library derived itself, so every direct
+ * write to elements has to be followed by touch_matrix() before the matrix
+ * is passed on
+ *
+ * @param m matrix_t pointer type
+ */
+void touch_matrix(matrix_t *m);
+
+/**
+ * @brief Creates arena with "capacity" bytes reserved up front. Arena grows
+ * by chunks when it runs out of space. Zero "capacity" reserves nothing
+ *
+ * @param capacity size_t type
+ * @return matrix_arena_t
+ */
+matrix_arena_t create_arena(size_t capacity);
+
+/**
+ * @brief Frees all memory of "arena" together with matrices created in it
+ *
+ * @param arena matrix_arena_t pointer type
+ */
+void remove_arena(matrix_arena_t *arena);
+
+/**
+ * @brief Takes "size" bytes aligned at MATRIX_ALIGNMENT from "arena"
+ *
+ * @param arena matrix_arena_t pointer type
+ * @param size size_t type
+ * @return void* or NULL if memory could not be allocated
+ */
+void *arena_alloc(matrix_arena_t *arena, size_t size);
+
+/**
+ * @brief Returns current position of "arena" to go back to later
+ *
+ * @param arena matrix_arena_t pointer type
+ * @return matrix_arena_mark_t
+ */
+matrix_arena_mark_t arena_mark(matrix_arena_t *arena);
+
+/**
+ * @brief Releases everything taken from "arena" after "mark". Zero mark
+ * empties arena. The largest released chunk is kept for reuse
+ *
+ * @param arena matrix_arena_t pointer type
+ * @param mark matrix_arena_mark_t type
+ */
+void arena_reset(matrix_arena_t *arena, matrix_arena_mark_t mark);
+
+/**
+ * @brief Makes every matrix created by the calling thread, results of
+ * operations included, come from "arena" until it is set back to NULL
+ *
+ * @param arena matrix_arena_t pointer type
+ */
+void set_matrix_arena(matrix_arena_t *arena);
+
+/**
+ * @brief Returns arena of the calling thread set by set_matrix_arena()
+ *
+ * @return matrix_arena_t*
+ */
+matrix_arena_t *get_matrix_arena(void);
+
+/**
+ * @brief Frees arena of library temporaries of the calling thread. Worth to
+ * call before the thread exits
+ */
+void release_matrix_scratch(void);
+
+/**
+ * @brief Sets number of threads operations are split between, the calling one
+ * included. 1 makes the library serial, 0 (default) uses all online cores.
+ * Worker threads are started lazily by the first large operation and persist
+ * between calls
+ *
+ * @param count int type
+ */
+void set_matrix_threads(int count);
+
+/**
+ * @brief Returns number of threads operations are split between
+ *
+ * @return int
+ */
+int get_matrix_threads(void);
+
+/**
+ * @brief Runs "task" over iterations [0, "count") in chunks of "grain"
+ * iterations and returns when all chunks are done. Range is halved
+ * recursively: the calling thread keeps the left half and leaves the right
+ * one in its deque, where idle pool threads steal it, so uneven chunks are
+ * balanced as they run. Loops called from a task split the same way. Runs
+ * serially when there is one chunk or while pool is busy with a loop of
+ * another thread
+ *
+ * @param count int type
+ * @param grain int type
+ * @param task matrix_task_t type
+ * @param arg void pointer type
+ */
+void parallel_for(int count, int grain, matrix_task_t task, void *arg);
+
+/**
+ * @brief Convenience alias of determinant(), which gives the same result:
+ * determinant() already factorizes by blocked LU with trailing updates run
+ * as stealable column block tasks
+ *
+ * @param a matrix_t pointer type
+ * @return double
+ */
+double matrix_parallel_determinant(matrix_t *a);
+
+/**
+ * @brief Convenience alias of inverse_matrix(), which gives the same result:
+ * inverse_matrix() already uses the blocked LU run as stealable tasks and
+ * substitution split by column blocks
+ *
+ * @param a matrix_t pointer type
+ * @return matrix_t
+ */
+matrix_t matrix_parallel_inverse(matrix_t *a);
+
+/**
+ * @brief Creates product of two matrices like mult_matrix(), halving the
+ * larger side of the result recursively down to tiles run as stealable tasks.
+ * gemm_blocked() behind mult_matrix() gives each thread one stripe, which
+ * balances only while all threads are free; tiles let idle threads take work
+ * from busy ones, e.g. when the product is called from inside a task.
+ * Always uses the classic product, never Strassen-Winograd
+ *
+ * @param a matrix_t pointer type
+ * @param b matrix_t pointer type
+ * @return matrix_t
+ */
+matrix_t matrix_parallel_mult(matrix_t *a, matrix_t *b);
+
+/**
+ * @brief Selects algorithm of mult_matrix() and mult_matrix_into() for all
+ * threads. Default PRODUCT_CLASSIC always uses blocked GEMM. With opt-in
+ * PRODUCT_AUTO products whose rows, columns and inner size all exceed
+ * Strassen cutoff are split into 7 half-size products by Strassen-Winograd
+ * recursion: fewer operations, but rounding error is bounded only relative to
+ * the largest element, not elementwise, so results differ from the classic
+ * product
+ *
+ * @param algorithm matrix_product_t type
+ */
+void set_matrix_product(matrix_product_t algorithm);
+
+/**
+ * @brief Returns algorithm selected by set_matrix_product()
+ *
+ * @return matrix_product_t
+ */
+matrix_product_t get_matrix_product(void);
+
+/**
+ * @brief Sets size at or below which Strassen-Winograd recursion stops and
+ * blocked GEMM takes over; non-positive "size" restores default 1024
+ *
+ * @param size int type
+ */
+void set_strassen_cutoff(int size);
+
+/**
+ * @brief Returns Strassen cutoff set by set_strassen_cutoff()
+ *
+ * @return int
+ */
+int get_strassen_cutoff(void);
+
+/**
+ * @brief Multiplies fixed-size matrices. mat2_t, mat3_t and mat4_t functions
+ * are fully unrolled and do no validation: NaN operands give NaN results
+ *
+ * @param a mat2_t pointer type
+ * @param b mat2_t pointer type
+ * @return mat2_t
+ */
+mat2_t mat2_mult(const mat2_t *a, const mat2_t *b);
+mat3_t mat3_mult(const mat3_t *a, const mat3_t *b);
+mat4_t mat4_mult(const mat4_t *a, const mat4_t *b);
+
+/**
+ * @brief Calculates determinant of fixed-size matrix, 4x4 one from 2x2
+ * minors of row pairs
+ *
+ * @param a mat2_t pointer type
+ * @return double
+ */
+double mat2_determinant(const mat2_t *a);
+double mat3_determinant(const mat3_t *a);
+double mat4_determinant(const mat4_t *a);
+
+/**
+ * @brief Writes inverse of fixed-size matrix to "res", which may be "a"
+ *
+ * @param a mat2_t pointer type
+ * @param res mat2_t pointer type
+ * @return int SUCCESS or FAILURE if "a" is singular
+ */
+int mat2_inverse(const mat2_t *a, mat2_t *res);
+int mat3_inverse(const mat3_t *a, mat3_t *res);
+int mat4_inverse(const mat4_t *a, mat4_t *res);
+
+/**
+ * @brief Returns transposed fixed-size matrix
+ *
+ * @param a mat2_t pointer type
+ * @return mat2_t
+ */
+mat2_t mat2_transpose(const mat2_t *a);
+mat3_t mat3_transpose(const mat3_t *a);
+mat4_t mat4_transpose(const mat4_t *a);
+
+/**
+ * @brief Copies correct matrix "a" of matching size into fixed-size "res"
+ *
+ * @param a matrix_t pointer type
+ * @param res mat2_t pointer type
+ * @return int SUCCESS or FAILURE
+ */
+int mat2_from_matrix(matrix_t *a, mat2_t *res);
+int mat3_from_matrix(matrix_t *a, mat3_t *res);
+int mat4_from_matrix(matrix_t *a, mat4_t *res);
+
+/**
+ * @brief Creates matrix with copy of fixed-size matrix
+ *
+ * @param a mat2_t pointer type
+ * @return matrix_t
+ */
+matrix_t mat2_to_matrix(const mat2_t *a);
+matrix_t mat3_to_matrix(const mat3_t *a);
+matrix_t mat4_to_matrix(const mat4_t *a);
+
+/**
+ * @brief Creates zeroed batch of "count" matrices with "rows" rows and
+ * "columns" columns. In case of error returns batch with NULL data
+ *
+ * @param count int type
+ * @param rows int type
+ * @param columns int type
+ * @return matrix_batch_t
+ */
+matrix_batch_t create_batch(int count, int rows, int columns);
+
+/**
+ * @brief Frees batch storage and clears the struct
+ *
+ * @param batch matrix_batch_t pointer type
+ */
+void remove_batch(matrix_batch_t *batch);
+
+/**
+ * @brief Copies matrix "a" of batch shape into batch slot "index"
+ *
+ * @param batch matrix_batch_t pointer type
+ * @param index int type
+ * @param a matrix_t pointer type
+ * @return int SUCCESS or FAILURE
+ */
+int batch_set(matrix_batch_t *batch, int index, matrix_t *a);
+
+/**
+ * @brief Creates matrix with copy of batch slot "index"
+ *
+ * @param batch matrix_batch_t pointer type
+ * @param index int type
+ * @return matrix_t
+ */
+matrix_t batch_get(matrix_batch_t *batch, int index);
+
+/**
+ * @brief Calculates determinants of all square matrices of batch into
+ * "result" array of batch count. Sizes up to 4 run unrolled across
+ * MATRIX_BATCH_LANES matrices at once
+ *
+ * @param a matrix_batch_t pointer type
+ * @param result double pointer type
+ * @return int SUCCESS or FAILURE
+ */
+int batch_determinant(matrix_batch_t *a, double *result);
+
+/**
+ * @brief Creates batch of inverses of all square matrices of batch "a".
+ * Singular matrices get NaN elements instead of failing the whole batch
+ *
+ * @param a matrix_batch_t pointer type
+ * @return matrix_batch_t
+ */
+matrix_batch_t batch_inverse(matrix_batch_t *a);
+
+/**
+ * @brief Creates batch of products of matrices of "a" and "b" pairwise
+ *
+ * @param a matrix_batch_t pointer type
+ * @param b matrix_batch_t pointer type
+ * @return matrix_batch_t
+ */
+matrix_batch_t batch_mult(matrix_batch_t *a, matrix_batch_t *b);
+
+/**
+ * @brief Creates batch of sums of matrices of "a" and "b" pairwise
+ *
+ * @param a matrix_batch_t pointer type
+ * @param b matrix_batch_t pointer type
+ * @return matrix_batch_t
+ */
+matrix_batch_t batch_sum(matrix_batch_t *a, matrix_batch_t *b);
+
+/**
+ * @brief Returns counters of heap allocations made by the library
+ *
+ * @return matrix_alloc_stats_t
+ */
+matrix_alloc_stats_t get_matrix_alloc_stats(void);
+
+/**
+ * @brief Enables cache of freed matrix buffers of the calling thread holding
+ * at most "bytes" bytes. Buffers are reused for matrices of the same storage
+ * size. Zero disables cache and frees everything it holds, worth to call
+ * before the thread exits
+ *
+ * @param bytes size_t type
+ */
+void set_matrix_cache_limit(size_t bytes);
+
+/**
+ * @brief Returns cache limit of the calling thread, 0 when cache is disabled
+ *
+ * @return size_t
+ */
+size_t get_matrix_cache_limit(void);
+
+/**
+ * @brief Returns buffer cache counters of the calling thread. Hit rate is
+ * hits / (hits + misses)
+ *
+ * @return matrix_cache_stats_t
+ */
+matrix_cache_stats_t get_matrix_cache_stats(void);
+
+/**
+ * @brief Allocates "size" bytes rounded up to and aligned at
+ * MATRIX_ALIGNMENT. Every library buffer goes through it and matrix_free(),
+ * so heap traffic is counted in one place
+ *
+ * @param size size_t type
+ * @return void pointer or NULL
+ */
+void *matrix_alloc(size_t size);
+
+/**
+ * @brief Frees buffer taken by matrix_alloc()
+ *
+ * @param ptr void pointer type
+ */
+void matrix_free(void *ptr);
+
 /**
  * @brief Checks and sets correct matrix type according to values defined at
  * the library as IDENTITY_MATRIX, ZERO_MATRIX or CORRECT_MATRIX
@@ -171,29 +969,82 @@ char base_check_matrices(matrix_t *a, matrix_t *b);
  */
 void check_matrix_type(matrix_t *m);
 
+/**
+ * @brief Returns 1 if matrix "a" is of "type" derived by the library, either
+ * by classification pass or from typed operands, and 0 for stamped types
+ *
+ * @param a matrix_t type
+ * @param type matrix_type_t type
+ * @return char
+ */
+char has_type(matrix_t a, matrix_type_t type);
+
+/**
+ * @brief Sets type of result "res" that follows from operand types; any type
+ * but UNKNOWN_MATRIX counts as derived by the library
+ *
+ * @param res matrix_t pointer type
+ * @param type matrix_type_t type
+ */
+void set_result_type(matrix_t *res, matrix_type_t type);
+
 /**
  * @brief Executes addition or substraction operations according to given
- * function "operator" with correct matrices and return result by "res" pointer
+ * "kernel" with correct matrices and return result by "res" pointer
  *
- * @param operator functions matrix_value_summ() or matrix_value_subb()
+ * @param kernel kernels matrix_kernels.add or matrix_kernels.sub
  * @param a matrix_t type
  * @param b matrix_t type
  * @param res matrix_t pointer type
  */
-void simple_matrix_operations(double operator(double, double), matrix_t a,
+void simple_matrix_operations(matrix_binary_kernel_t kernel, matrix_t a,
                               matrix_t b, matrix_t *res);
 
 /**
- * @brief Calculates new element of matrix while multiplying two others
+ * @brief Returns name of SIMD kernel set chosen by CPUID at load time:
+ * "avx512", "avx2" or "scalar" fallback
  *
- * @param a matrix_t type
- * @param b matrix_t type
- * @param i int type
- * @param j int type
- * @param res double pointer type
+ * @return const char pointer
  */
-void calculate_multiplied_matrix_element(matrix_t a, matrix_t b, int i, int j,
-                                         double *res);
+const char *matrix_simd_level(void);
+
+/**
+ * @brief Calculates C = alpha * A * B + beta * C, where A is m*k, B is k*n and
+ * C is m*n. A and B are addressed with row and column strides ("rs", "cs") so
+ * any strided or transposed layout can be fed without copying; C is row-major
+ * with leading dimension "ldc". Large products are packed into contiguous
+ * L1/L2-sized panels and run through a register-blocked micro-kernel; alpha
+ * is applied while packing A and beta when the first k panel is stored, so
+ * neither takes an extra pass. Zero beta does not read C. Used in
+ * mult_matrix() and gemm_matrix() functions
+ *
+ * @return char 1 or 0 if packing buffers could not be allocated
+ */
+char gemm_blocked(int m, int n, int k, double alpha, const double *a, int rsa,
+                  int csa, const double *b, int rsb, int csb, double beta,
+                  double *c, int ldc);
+
+/**
+ * @brief Calculates C = A * B for row-major arrays with algorithm chosen by
+ * set_matrix_product(). Strassen-Winograd temporaries for the whole recursion
+ * are taken from the scratch arena at once, odd sizes are peeled off and
+ * added by thin gemm_blocked() products, which also computes the base case.
+ * "c" must not overlap "a" or "b"
+ *
+ * @return char 1 or 0 if packing buffers could not be allocated
+ */
+char gemm_product(int m, int n, int k, const double *a, int lda,
+                  const double *b, int ldb, double *c, int ldc);
+
+/**
+ * @brief Calculates the same as gemm_blocked() on the calling thread only.
+ * Used for tiles of products already split between threads
+ *
+ * @return char 1 or 0 if packing buffers could not be allocated
+ */
+char gemm_serial(int m, int n, int k, double alpha, const double *a, int rsa,
+                 int csa, const double *b, int rsb, int csb, double beta,
+                 double *c, int ldc);
 
 /**
  * @brief Calculates algebraic additions to the specific matrix element placed
@@ -206,6 +1057,67 @@ void calculate_multiplied_matrix_element(matrix_t a, matrix_t b, int i, int j,
  */
 double algebraic_addition(matrix_t a, int row, int col);
 
+/**
+ * @brief Calculates inverse of square matrix "a" into "res" of the same size
+ * by blocked LU factorization in one scratch buffer. Used in inverse_matrix()
+ * function
+ *
+ * @param a matrix_t type
+ * @param res matrix_t pointer type
+ * @return char 1 or 0 if "a" is singular or scratch memory could not be
+ * allocated
+ */
+char calculate_LU_inverse(matrix_t a, matrix_t *res);
+
+/**
+ * @brief Calculates algebraic additions matrix of square matrix "a" into "res"
+ * of the same size in O(n^3). Matrices inverse_matrix() accepts take
+ * det(A) * A^-T from LU factorization; the rest fall back to LU with complete
+ * pivoting: without zero pivots det(A) * A^-T is taken from it, rank n-1
+ * cofactors are built from null vectors and only lower rank gives zeros.
+ * Used in calc_complements() function
+ *
+ * @param a matrix_t type
+ * @param res matrix_t pointer type
+ * @return char 1 or 0 if scratch memory could not be allocated
+ */
+char calculate_LU_complements(matrix_t a, matrix_t *res);
+
+/**
+ * @brief Factorizes n*n row-major array "a" with leading dimension "lda" in
+ * place as P * A = L * U. Writes permutation to "pivots" and its parity to
+ * "sign". Zero pivot columns are skipped, so singular matrices get zero on
+ * U diagonal. Works by panels of columns: each panel is factorized row-wise,
+ * then trailing matrix is updated by triangular solve and gemm_blocked() in
+ * column block tasks run through parallel_for(), so most of the work runs in
+ * the GEMM kernel on cached blocks instead of streaming the trailing matrix
+ * once per pivot
+ *
+ * @return char 1 or 0 if scratch memory could not be allocated
+ */
+char lu_factor_blocked(double *a, int n, int lda, int *pivots, int *sign);
+
+/**
+ * @brief Factorizes n*n row-major array "a" in place as P * A * Q = L * U with
+ * complete pivoting, so zero pivots gather at the end of U diagonal and reveal
+ * rank. Writes row and column permutations to "rows" and "cols"
+ */
+void lu_factor_complete(double *a, int n, int lda, int *rows, int *cols,
+                        int *sign);
+
+/**
+ * @brief Overwrites n*nrhs array "x" holding P * B with solution of
+ * L * U * X = P * B using factorization from lu_factor_blocked()
+ */
+void lu_substitute(const double *lu, int n, int ldlu, double *x, int nrhs,
+                   int ldx);
+
+/**
+ * @brief Solves like lu_substitute() for all "n" right-hand side columns of
+ * n*n "x", split by column blocks between threads with parallel_for()
+ */
+void lu_substitute_columns(const double *lu, int n, double *x, int ldx);
+
 /**
  * @brief Sets error to matrix state in case of any error and impossibility
  * carrying operation
@@ -218,16 +1130,62 @@ void matrix_error(matrix_t *m);
     Auxiliary functions used in second and more of nesting level relatively
    general function
 */
-void scan_column_to_find_nonzero_num(matrix_t *a, const int row, const int col,
-                                     char *zero);
-void this_row_plus_that_row(matrix_t *a, const int row_num, const int row_zero);
-void process_the_row(matrix_t *a, const int row, int col, char *zero);
 void make_matrix_minor(matrix_t a, int row, int col, matrix_t *minor);
 void check_matrix_status(matrix_t *a, char *state);
-double matrix_value_summ(double a, double b);
-double matrix_value_subb(double a, double b);
 void copy_matrix(matrix_t a, matrix_t *b);
 double multiply_diagonal(matrix_t a);
 void print_matrix(matrix_t m);
+size_t matrix_data_size(int rows, int columns);
+size_t matrix_rows_size(int rows);
+void bind_matrix_rows(matrix_t *m);
+size_t matrix_size(matrix_t *m);
+int elementwise_grain(int columns);
+void swap_rows(double *a, double *b, int n);
+void lu_error(lu_t *lu);
+void adjugate_transposed_of_complete_lu(const double *lu, int n,
+                                        const int *rows, const int *cols,
+                                        int sign, double *x, double *y,
+                                        matrix_t *res);
+void copy_to_scratch(matrix_t a, double *scratch);
+double lu_diagonal_product(const double *lu, int n, int ldlu, int sign);
+char has_nan(const double *data, size_t n);
+void transpose_and_scale(double *a, int n, int lda, double number);
+char check_output(matrix_t *out, int rows, int columns);
+matrix_arena_t *matrix_scratch(void);
+void arena_grow(matrix_arena_t *arena, size_t size);
+matrix_t allocate_matrix(matrix_arena_t *arena, int rows, int columns);
+size_t matrix_storage_size(int rows, int columns);
+void *matrix_buffer_take(size_t size);
+void matrix_buffer_give(void *ptr, size_t size);
+void view_error(matrix_view_t *view);
+char check_view(matrix_view_t a);
+double view_element(matrix_view_t a, int i, int j);
+char view_is_strided(matrix_view_t a);
+void copy_view(matrix_view_t a, double *dst, int ld);
+matrix_view_t pack_view(matrix_view_t a);
+double calculate_view_determinant(matrix_view_t a);
+double calculate_Gauss_determinant_view(matrix_view_t a);
+void transpose_block(const double *a, int lda, double *b, int ldb, int rows,
+                     int columns);
+void transpose_recursive(const double *a, int lda, double *b, int ldb,
+                         int rows, int columns);
+void transpose_tile(const double *a, int lda, double *b, int ldb, int rows,
+                    int columns);
+void transpose_square(double *a, int n, int lda);
+void swap_transposed(double *a, double *b, int rows, int columns, int lda);
+void calculate_scaled_matrix(matrix_t a, double number, matrix_t *res);
+char calculate_matrix_product(matrix_t a, matrix_t b, matrix_t *res);
+void calculate_transposed_matrix(matrix_t a, matrix_t *res);
+char calculate_complements(matrix_t a, matrix_t *res);
+matrix_batch_t allocate_batch(int count, int rows, int columns);
+void mat4_minors(const mat4_t *a, double s[6], double c[6]);
+int copy_to_fixed(matrix_t *a, int n, double *res);
+matrix_t copy_from_fixed(const double *a, int n);
+void batch_error(matrix_batch_t *batch);
+char check_batch(matrix_batch_t *a);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif  // SRC_S21_MATRIX_H_
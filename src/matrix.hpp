@@ -0,0 +1,524 @@
+#ifndef SRC_S21_MATRIX_HPP_
+#define SRC_S21_MATRIX_HPP_
+
+#include <cmath>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "matrix.h"
+
+namespace s21 {
+
+class Matrix;
+
+// base of lazy expression nodes built by the operators below Matrix; nothing
+// is computed until a node is assigned to a Matrix
+struct Expression {};
+
+namespace expression {
+
+template <class T>
+constexpr bool kIsNode = std::is_base_of_v<Expression, std::decay_t<T>>;
+
+template <class T>
+constexpr bool kIsOperand =
+    kIsNode<T> || std::is_same_v<std::decay_t<T>, Matrix>;
+
+template <class L, class R>
+class Product;
+
+template <class T>
+struct IsProduct : std::false_type {};
+
+template <class L, class R>
+struct IsProduct<Product<L, R>> : std::true_type {};
+
+// elements one step of fused evaluation computes together
+constexpr int kEvaluationBlock = 8;
+
+template <class E>
+struct Evaluation {
+  const E *expression;
+  matrix_t *result;
+};
+
+template <class E>
+void EvaluateRows(void *arg, int begin, int end) {
+  const Evaluation<E> *job = static_cast<const Evaluation<E> *>(arg);
+  const E &expression = *job->expression;
+  int columns = job->result->columns;
+
+  for (int i = begin; i < end; i++) {
+    double *row = job->result->data + static_cast<size_t>(i) *
+                                          job->result->stride;
+    int j = 0;
+    // element (i, j) of the result reads only elements (i, j) of operands,
+    // so the result may share storage with any of them; a block is read
+    // before it is written, which lets the compiler use vector registers
+    for (; j + kEvaluationBlock <= columns; j += kEvaluationBlock) {
+      double block[kEvaluationBlock];
+      for (int k = 0; k < kEvaluationBlock; k++) {
+        block[k] = expression.Element(i, j + k);
+      }
+      for (int k = 0; k < kEvaluationBlock; k++) row[j + k] = block[k];
+    }
+    for (; j < columns; j++) row[j] = expression.Element(i, j);
+  }
+}
+
+// whole expression in one pass over "result", rows split between threads
+template <class E>
+void Evaluate(const E &expression, matrix_t *result) {
+  Evaluation<E> job = {&expression, result};
+
+  parallel_for(result->rows, elementwise_grain(result->stride),
+               EvaluateRows<E>, &job);
+  touch_matrix(result);
+}
+
+}  // namespace expression
+
+// owner of one matrix_t: storage is given back by the destructor, moves steal
+// it and copies are explicit through Clone()
+class Matrix {
+ public:
+  Matrix() noexcept : matrix_(Null()) {}
+
+  /**
+   * @brief Creates zero matrix of given size
+   *
+   * @throw std::invalid_argument for non-positive size
+   * @throw std::bad_alloc when storage can not be allocated
+   */
+  Matrix(int rows, int columns) : matrix_(create_matrix(rows, columns)) {
+    if (!matrix_.matrix) {
+      if (rows > 0 && columns > 0) throw std::bad_alloc();
+      throw std::invalid_argument("matrix size must be positive");
+    }
+  }
+
+  /**
+   * @brief Takes ownership of result of a C function, incorrect matrix is
+   * rejected
+   *
+   * @throw std::invalid_argument when "matrix" is incorrect
+   */
+  explicit Matrix(matrix_t matrix) : matrix_(Checked(matrix)) {}
+
+  /**
+   * @brief Evaluates lazy expression like 2 * a + b - c in one fused pass;
+   * storage of a temporary operand or product of the same size is reused
+   *
+   * @throw std::invalid_argument for incorrect operands
+   */
+  template <class E, class = std::enable_if_t<expression::kIsNode<E>>>
+  Matrix(E &&e) : matrix_(Null()) {  // NOLINT(runtime/explicit)
+    Assign(std::forward<E>(e));
+  }
+
+  // evaluates in place when sizes match, see Matrix(E &&e)
+  template <class E, class = std::enable_if_t<expression::kIsNode<E>>>
+  Matrix &operator=(E &&e) {
+    Assign(std::forward<E>(e));
+    return *this;
+  }
+
+  Matrix(const Matrix &other) = delete;
+  Matrix &operator=(const Matrix &other) = delete;
+
+  Matrix(Matrix &&other) noexcept : matrix_(other.matrix_) {
+    other.matrix_ = Null();
+  }
+
+  Matrix &operator=(Matrix &&other) noexcept {
+    if (this != &other) {
+      remove_matrix(&matrix_);
+      matrix_ = other.matrix_;
+      other.matrix_ = Null();
+    }
+    return *this;
+  }
+
+  ~Matrix() { remove_matrix(&matrix_); }
+
+  // deep copy: the only way to duplicate storage
+  Matrix Clone() const { return Matrix(mult_number(Raw(), 1.0)); }
+
+  int Rows() const noexcept { return matrix_.rows; }
+  int Columns() const noexcept { return matrix_.columns; }
+  bool Empty() const noexcept { return !matrix_.matrix; }
+
+  /**
+   * @brief Element access; writable reference resets cached type and
+   * validation of the matrix
+   *
+   * @throw std::out_of_range for indices outside of the matrix
+   */
+  double &operator()(int row, int column) {
+    CheckIndex(row, column);
+    touch_matrix(&matrix_);
+    return matrix_.matrix[row][column];
+  }
+
+  double operator()(int row, int column) const {
+    CheckIndex(row, column);
+    return matrix_.matrix[row][column];
+  }
+
+  // underlying struct for C functions not wrapped here; ownership stays
+  matrix_t *Get() noexcept { return &matrix_; }
+  const matrix_t *Get() const noexcept { return &matrix_; }
+
+  // gives up ownership, caller frees the result with remove_matrix()
+  matrix_t Release() noexcept {
+    matrix_t matrix = matrix_;
+    matrix_ = Null();
+    return matrix;
+  }
+
+  template <class E, class = std::enable_if_t<expression::kIsOperand<E>>>
+  Matrix &operator+=(E &&e) {
+    return *this = *this + std::forward<E>(e);
+  }
+
+  template <class E, class = std::enable_if_t<expression::kIsOperand<E>>>
+  Matrix &operator-=(E &&e) {
+    return *this = *this - std::forward<E>(e);
+  }
+
+  Matrix &operator*=(double number) {
+    Require(mult_number_inplace(&matrix_, number));
+    return *this;
+  }
+
+  template <class E, class = std::enable_if_t<expression::kIsOperand<E>>>
+  Matrix &operator*=(E &&e) {
+    return *this = *this * std::forward<E>(e);
+  }
+
+  Matrix Transpose() const { return Matrix(transpose(Raw())); }
+  Matrix Complements() const { return Matrix(calc_complements(Raw())); }
+  Matrix Inverse() const { return Matrix(inverse_matrix(Raw())); }
+
+  /**
+   * @throw std::invalid_argument for incorrect or non-square matrix
+   */
+  double Determinant() const {
+    double returnable = determinant(Raw());
+    if (std::isnan(returnable)) {
+      throw std::invalid_argument("incorrect or non-square matrix");
+    }
+    return returnable;
+  }
+
+ private:
+  static matrix_t Null() noexcept {
+    matrix_t matrix = {};
+    matrix.matrix_type = INCORRECT_MATRIX;
+    return matrix;
+  }
+
+  static matrix_t Checked(matrix_t matrix) {
+    if (!matrix.matrix || matrix.matrix_type == INCORRECT_MATRIX) {
+      remove_matrix(&matrix);
+      throw std::invalid_argument("incorrect matrix");
+    }
+    return matrix;
+  }
+
+  static void Require(int state) {
+    if (state != SUCCESS) throw std::invalid_argument("incorrect operands");
+  }
+
+  // C functions take mutable pointers: validation caching updates the struct
+  matrix_t *Raw() const noexcept { return &matrix_; }
+
+  template <class E>
+  void Assign(E &&e) {
+    Matrix *spare = nullptr;
+
+    e.Prepare();
+    // operands of an lvalue expression may be evaluated again later
+    if constexpr (!std::is_lvalue_reference_v<E>) spare = e.Spare();
+    if (spare && expression::IsProduct<std::decay_t<E>>::value) {
+      // nothing to add to the GEMM result
+      *this = std::move(*spare);
+    } else if (spare) {
+      expression::Evaluate(e, &spare->matrix_);
+      *this = std::move(*spare);
+    } else if (!Empty() && Rows() == e.Rows() && Columns() == e.Columns()) {
+      expression::Evaluate(e, &matrix_);
+    } else {
+      Matrix result(allocate_matrix(get_matrix_arena(), e.Rows(), e.Columns()));
+      expression::Evaluate(e, &result.matrix_);
+      *this = std::move(result);
+    }
+  }
+
+  void CheckIndex(int row, int column) const {
+    if (row < 0 || row >= matrix_.rows || column < 0 ||
+        column >= matrix_.columns) {
+      throw std::out_of_range("matrix index out of range");
+    }
+  }
+
+  mutable matrix_t matrix_;
+};
+
+namespace expression {
+
+// C functions take mutable pointers, see Matrix::Raw()
+inline matrix_t *Raw(const Matrix &matrix) {
+  return const_cast<matrix_t *>(matrix.Get());
+}
+
+// element storage of an evaluated matrix
+class Leaf : public Expression {
+ public:
+  double Element(int row, int column) const {
+    return data_[static_cast<size_t>(row) * stride_ + column];
+  }
+
+ protected:
+  void Bind(const Matrix &matrix, bool validate) const {
+    if (validate && !base_check_matrices(Raw(matrix), NULL)) {
+      throw std::invalid_argument("incorrect matrix");
+    }
+    data_ = matrix.Get()->data;
+    stride_ = matrix.Get()->stride;
+  }
+
+ private:
+  mutable const double *data_ = nullptr;
+  mutable int stride_ = 0;
+};
+
+// named matrix, read where it is
+class Reference : public Leaf {
+ public:
+  explicit Reference(const Matrix &matrix) : matrix_(matrix) {}
+
+  int Rows() const { return matrix_.Rows(); }
+  int Columns() const { return matrix_.Columns(); }
+  void Prepare() const { Bind(matrix_, true); }
+  Matrix *Spare() { return nullptr; }
+  matrix_t *Raw() const { return expression::Raw(matrix_); }
+
+ private:
+  const Matrix &matrix_;
+};
+
+// temporary matrix moved into the expression; the result may take its storage
+class Owned : public Leaf {
+ public:
+  explicit Owned(Matrix &&matrix) : matrix_(std::move(matrix)) {}
+
+  int Rows() const { return matrix_.Rows(); }
+  int Columns() const { return matrix_.Columns(); }
+  void Prepare() const { Bind(matrix_, true); }
+  Matrix *Spare() { return &matrix_; }
+  matrix_t *Raw() const { return expression::Raw(matrix_); }
+
+ private:
+  Matrix matrix_;
+};
+
+template <class L, class R, class Operation>
+class Elementwise : public Expression {
+ public:
+  Elementwise(L left, R right)
+      : left_(std::move(left)), right_(std::move(right)) {
+    if (left_.Rows() != right_.Rows() || left_.Columns() != right_.Columns()) {
+      throw std::invalid_argument("matrix sizes differ");
+    }
+  }
+
+  int Rows() const { return left_.Rows(); }
+  int Columns() const { return left_.Columns(); }
+  void Prepare() const {
+    left_.Prepare();
+    right_.Prepare();
+  }
+  double Element(int row, int column) const {
+    return Operation()(left_.Element(row, column), right_.Element(row, column));
+  }
+  Matrix *Spare() {
+    Matrix *spare = left_.Spare();
+    return spare ? spare : right_.Spare();
+  }
+
+ private:
+  L left_;
+  R right_;
+};
+
+template <class E>
+class Scaled : public Expression {
+ public:
+  Scaled(E e, double number) : e_(std::move(e)), number_(number) {}
+
+  int Rows() const { return e_.Rows(); }
+  int Columns() const { return e_.Columns(); }
+  void Prepare() const { e_.Prepare(); }
+  double Element(int row, int column) const {
+    return number_ * e_.Element(row, column);
+  }
+  Matrix *Spare() { return e_.Spare(); }
+
+ private:
+  E e_;
+  double number_;
+};
+
+// alpha * L * R; computed by blocked GEMM before the elementwise pass, and
+// that result is the storage the pass writes to unless a bigger node has one
+template <class L, class R>
+class Product : public Leaf {
+ public:
+  Product(L left, R right, double alpha)
+      : left_(std::move(left)), right_(std::move(right)), alpha_(alpha) {
+    if (left_.Columns() != right_.Rows()) {
+      throw std::invalid_argument("matrix sizes do not match for product");
+    }
+  }
+
+  int Rows() const { return left_.Rows(); }
+  int Columns() const { return right_.Columns(); }
+  void Prepare() const {
+    if (result_.Empty()) {
+      Matrix result(allocate_matrix(get_matrix_arena(), Rows(), Columns()));
+      if (!gemm_matrix(0, 0, alpha_, left_.Raw(), right_.Raw(), 0.0,
+                       result.Get())) {
+        throw std::invalid_argument("incorrect operands");
+      }
+      result_ = std::move(result);
+    }
+    Bind(result_, false);
+  }
+  Matrix *Spare() { return &result_; }
+
+  // folds a scalar factor into alpha
+  Product Times(double number) && {
+    alpha_ *= number;
+    return std::move(*this);
+  }
+
+ private:
+  L left_;
+  R right_;
+  double alpha_;
+  mutable Matrix result_;
+};
+
+// lvalue matrices are referenced, temporaries and nodes are moved in
+template <class T>
+auto Operand(T &&e) {
+  if constexpr (!std::is_same_v<std::decay_t<T>, Matrix>) {
+    return std::decay_t<T>(std::forward<T>(e));
+  } else if constexpr (std::is_lvalue_reference_v<T>) {
+    return Reference(e);
+  } else {
+    return Owned(std::move(e));
+  }
+}
+
+// product operands must be stored matrices, so nodes are evaluated here
+template <class T>
+auto MatrixOperand(T &&e) {
+  if constexpr (std::is_same_v<std::decay_t<T>, Matrix>) {
+    return Operand(std::forward<T>(e));
+  } else {
+    return Owned(Matrix(std::forward<T>(e)));
+  }
+}
+
+template <class T>
+decltype(auto) Materialize(T &&e) {
+  if constexpr (std::is_same_v<std::decay_t<T>, Matrix>) {
+    return std::forward<T>(e);
+  } else {
+    return Matrix(std::forward<T>(e));
+  }
+}
+
+template <class T>
+using OperandOf = decltype(Operand(std::declval<T>()));
+
+template <class T>
+using MatrixOperandOf = decltype(MatrixOperand(std::declval<T>()));
+
+template <class L, class R>
+constexpr bool kAreOperands = kIsOperand<L> && kIsOperand<R>;
+
+}  // namespace expression
+
+template <class L, class R,
+          class = std::enable_if_t<expression::kAreOperands<L, R>>>
+auto operator+(L &&left, R &&right) {
+  return expression::Elementwise<expression::OperandOf<L>,
+                                 expression::OperandOf<R>, std::plus<double>>(
+      expression::Operand(std::forward<L>(left)),
+      expression::Operand(std::forward<R>(right)));
+}
+
+template <class L, class R,
+          class = std::enable_if_t<expression::kAreOperands<L, R>>>
+auto operator-(L &&left, R &&right) {
+  return expression::Elementwise<expression::OperandOf<L>,
+                                 expression::OperandOf<R>, std::minus<double>>(
+      expression::Operand(std::forward<L>(left)),
+      expression::Operand(std::forward<R>(right)));
+}
+
+template <class E, class = std::enable_if_t<expression::kIsOperand<E>>>
+auto operator*(double number, E &&e) {
+  using Node = std::decay_t<E>;
+  if constexpr (expression::IsProduct<Node>::value &&
+                !std::is_lvalue_reference_v<E>) {
+    return std::move(e).Times(number);
+  } else {
+    return expression::Scaled<expression::OperandOf<E>>(
+        expression::Operand(std::forward<E>(e)), number);
+  }
+}
+
+template <class E, class = std::enable_if_t<expression::kIsOperand<E>>>
+auto operator*(E &&e, double number) {
+  return number * std::forward<E>(e);
+}
+
+template <class E, class = std::enable_if_t<expression::kIsOperand<E>>>
+auto operator-(E &&e) {
+  return -1.0 * std::forward<E>(e);
+}
+
+template <class L, class R,
+          class = std::enable_if_t<expression::kAreOperands<L, R>>>
+auto operator*(L &&left, R &&right) {
+  return expression::Product<expression::MatrixOperandOf<L>,
+                             expression::MatrixOperandOf<R>>(
+      expression::MatrixOperand(std::forward<L>(left)),
+      expression::MatrixOperand(std::forward<R>(right)), 1.0);
+}
+
+template <class L, class R,
+          class = std::enable_if_t<expression::kAreOperands<L, R>>>
+bool operator==(L &&left, R &&right) {
+  const Matrix &a = expression::Materialize(std::forward<L>(left));
+  const Matrix &b = expression::Materialize(std::forward<R>(right));
+
+  return eq_matrix(expression::Raw(a), expression::Raw(b)) == SUCCESS;
+}
+
+template <class L, class R,
+          class = std::enable_if_t<expression::kAreOperands<L, R>>>
+bool operator!=(L &&left, R &&right) {
+  return !(std::forward<L>(left) == std::forward<R>(right));
+}
+
+}  // namespace s21
+
+#endif  // SRC_S21_MATRIX_HPP_
@@ -0,0 +1,143 @@
+#include "matrix.h"
+
+// chunk header size keeps chunk storage MATRIX_ALIGNMENT-aligned
+#define ARENA_HEADER MATRIX_ALIGNMENT
+// smallest chunk taken from the heap
+#define ARENA_MIN_CHUNK ((size_t)64 << 10)
+// released chunks larger than this go back to the heap instead of reuse
+#define ARENA_SPARE_LIMIT ((size_t)64 << 20)
+
+_Static_assert(sizeof(matrix_arena_chunk_t) <= ARENA_HEADER,
+               "arena chunk header does not fit its alignment");
+
+// arena of library temporaries of the calling thread
+static _Thread_local matrix_arena_t scratch_arena = {NULL, NULL};
+// arena of operations results of the calling thread, see set_matrix_arena()
+static _Thread_local matrix_arena_t *result_arena = NULL;
+
+matrix_arena_t create_arena(size_t capacity) {
+  matrix_arena_t arena = {NULL, NULL};
+
+  if (capacity) arena_grow(&arena, capacity);
+
+  return arena;
+}
+
+void remove_arena(matrix_arena_t *arena) {
+  if (arena) {
+    arena_reset(arena, (matrix_arena_mark_t){NULL, 0});
+    matrix_free(arena->spare);
+    arena->spare = NULL;
+  }
+}
+
+void *arena_alloc(matrix_arena_t *arena, size_t size) {
+  matrix_arena_chunk_t *chunk = NULL;
+  void *returnable = NULL;
+
+  size = (size + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+  if (arena) {
+    chunk = arena->chunk;
+    if (!chunk || chunk->size - chunk->used < size) {
+      arena_grow(arena, size);
+      chunk = arena->chunk;
+    }
+    if (chunk && chunk->size - chunk->used >= size) {
+      returnable = (char *)chunk + ARENA_HEADER + chunk->used;
+      chunk->used += size;
+    }
+  }
+
+  return returnable;
+}
+
+matrix_arena_mark_t arena_mark(matrix_arena_t *arena) {
+  matrix_arena_mark_t mark = {NULL, 0};
+
+  if (arena && arena->chunk) {
+    mark.chunk = arena->chunk;
+    mark.used = arena->chunk->used;
+  }
+
+  return mark;
+}
+
+void arena_reset(matrix_arena_t *arena, matrix_arena_mark_t mark) {
+  while (arena && arena->chunk && arena->chunk != mark.chunk) {
+    matrix_arena_chunk_t *chunk = arena->chunk;
+    arena->chunk = chunk->previous;
+    // the largest released chunk is kept, so steady loops stop growing
+    if (chunk->size <= ARENA_SPARE_LIMIT &&
+        (!arena->spare || arena->spare->size < chunk->size)) {
+      matrix_free(arena->spare);
+      arena->spare = chunk;
+    } else {
+      matrix_free(chunk);
+    }
+  }
+  if (arena && arena->chunk) arena->chunk->used = mark.used;
+}
+
+matrix_t create_matrix_in(matrix_arena_t *arena, int rows, int columns) {
+  matrix_t matrix;
+
+  matrix = allocate_matrix(arena, rows, columns);
+  if (matrix.matrix) {
+    memset(matrix.data, 0, sizeof(double) * matrix_size(&matrix));
+    matrix.matrix_type = ZERO_MATRIX;
+  }
+
+  return matrix;
+}
+
+matrix_t allocate_matrix(matrix_arena_t *arena, int rows, int columns) {
+  matrix_t matrix;
+
+  matrix_error(&matrix);
+  if (rows > 0 && columns > 0) {
+    size_t size = matrix_storage_size(rows, columns);
+    matrix.data = (double *)(arena ? arena_alloc(arena, size)
+                                   : matrix_buffer_take(size));
+    if (matrix.data) {
+      matrix.rows = rows;
+      matrix.columns = columns;
+      matrix.stride = columns;
+      matrix.matrix =
+          (double **)((char *)matrix.data + matrix_data_size(rows, columns));
+      bind_matrix_rows(&matrix);
+      matrix.matrix_type = UNKNOWN_MATRIX;
+      matrix.in_arena = arena != NULL;
+    }
+  }
+
+  return matrix;
+}
+
+void set_matrix_arena(matrix_arena_t *arena) { result_arena = arena; }
+
+matrix_arena_t *get_matrix_arena(void) { return result_arena; }
+
+void release_matrix_scratch(void) { remove_arena(&scratch_arena); }
+
+matrix_arena_t *matrix_scratch(void) { return &scratch_arena; }
+
+void arena_grow(matrix_arena_t *arena, size_t size) {
+  matrix_arena_chunk_t *chunk = NULL;
+
+  if (arena->spare && arena->spare->size >= size) {
+    chunk = arena->spare;
+    arena->spare = NULL;
+  } else {
+    if (arena->chunk && size < 2 * arena->chunk->size) {
+      size = 2 * arena->chunk->size;
+    }
+    if (size < ARENA_MIN_CHUNK) size = ARENA_MIN_CHUNK;
+    chunk = (matrix_arena_chunk_t *)matrix_alloc(ARENA_HEADER + size);
+    if (chunk) chunk->size = size;
+  }
+  if (chunk) {
+    chunk->used = 0;
+    chunk->previous = arena->chunk;
+    arena->chunk = chunk;
+  }
+}
@@ -0,0 +1,448 @@
+#include "matrix.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BATCH_X86 1
+#endif
+
+// largest size unrolled across lanes, larger matrices go lane by lane
+#define BATCH_UNROLLED 4
+
+// one element of MATRIX_BATCH_LANES matrices; width is lowered to vector
+// registers of the target each task variant is compiled for
+typedef double batch_lanes_t
+    __attribute__((vector_size(sizeof(double) * MATRIX_BATCH_LANES)));
+
+// operands and result of one batch operation; tasks take blocks of lanes
+typedef struct batch_job_struct {
+  const double *a;
+  const double *b;
+  double *res;
+  int rows;     // of result
+  int columns;  // of result
+  int inner;    // columns of "a" in products
+  int count;
+  int blocks;  // stride / MATRIX_BATCH_LANES
+} batch_job_t;
+
+typedef struct batch_tasks_struct {
+  matrix_task_t determinant;
+  matrix_task_t inverse;
+  matrix_task_t product;
+} batch_tasks_t;
+
+static inline __attribute__((always_inline)) void batch_load(
+    const batch_job_t *job, int block, batch_lanes_t *x) {
+  const batch_lanes_t *a = (const batch_lanes_t *)job->a + block;
+
+  for (int e = 0; e < job->rows * job->columns; e++) {
+    x[e] = a[(size_t)e * job->blocks];
+  }
+}
+
+// determinant of "n" <= 4 and, when "adjugate" is given, transposed cofactors
+static inline __attribute__((always_inline)) void batch_small_inverse(
+    const batch_lanes_t *x, int n, batch_lanes_t *det,
+    batch_lanes_t *adjugate) {
+  if (n == 1) {
+    batch_lanes_t zero = {0};
+    *det = x[0];
+    if (adjugate) adjugate[0] = zero + 1.0;
+  } else if (n == 2) {
+    *det = x[0] * x[3] - x[1] * x[2];
+    if (adjugate) {
+      adjugate[0] = x[3];
+      adjugate[1] = -x[1];
+      adjugate[2] = -x[2];
+      adjugate[3] = x[0];
+    }
+  } else if (n == 3) {
+    batch_lanes_t cofactors[9];
+    // cyclic indices give cofactor sign
+    for (int i = 0; i < 3; i++) {
+      int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+      for (int j = 0; j < 3; j++) {
+        int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+        cofactors[i * 3 + j] = x[i1 * 3 + j1] * x[i2 * 3 + j2] -
+                               x[i1 * 3 + j2] * x[i2 * 3 + j1];
+      }
+    }
+    *det = x[0] * cofactors[0] + x[1] * cofactors[1] + x[2] * cofactors[2];
+    for (int i = 0; adjugate && i < 3; i++) {
+      for (int j = 0; j < 3; j++) adjugate[i * 3 + j] = cofactors[j * 3 + i];
+    }
+  } else {
+    // 2x2 minors of the upper ("s") and lower ("c") row pairs
+    batch_lanes_t s0 = x[0] * x[5] - x[4] * x[1];
+    batch_lanes_t s1 = x[0] * x[6] - x[4] * x[2];
+    batch_lanes_t s2 = x[0] * x[7] - x[4] * x[3];
+    batch_lanes_t s3 = x[1] * x[6] - x[5] * x[2];
+    batch_lanes_t s4 = x[1] * x[7] - x[5] * x[3];
+    batch_lanes_t s5 = x[2] * x[7] - x[6] * x[3];
+    batch_lanes_t c5 = x[10] * x[15] - x[14] * x[11];
+    batch_lanes_t c4 = x[9] * x[15] - x[13] * x[11];
+    batch_lanes_t c3 = x[9] * x[14] - x[13] * x[10];
+    batch_lanes_t c2 = x[8] * x[15] - x[12] * x[11];
+    batch_lanes_t c1 = x[8] * x[14] - x[12] * x[10];
+    batch_lanes_t c0 = x[8] * x[13] - x[12] * x[9];
+    *det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if (adjugate) {
+      adjugate[0] = x[5] * c5 - x[6] * c4 + x[7] * c3;
+      adjugate[1] = -x[1] * c5 + x[2] * c4 - x[3] * c3;
+      adjugate[2] = x[13] * s5 - x[14] * s4 + x[15] * s3;
+      adjugate[3] = -x[9] * s5 + x[10] * s4 - x[11] * s3;
+      adjugate[4] = -x[4] * c5 + x[6] * c2 - x[7] * c1;
+      adjugate[5] = x[0] * c5 - x[2] * c2 + x[3] * c1;
+      adjugate[6] = -x[12] * s5 + x[14] * s2 - x[15] * s1;
+      adjugate[7] = x[8] * s5 - x[10] * s2 + x[11] * s1;
+      adjugate[8] = x[4] * c4 - x[5] * c2 + x[7] * c0;
+      adjugate[9] = -x[0] * c4 + x[1] * c2 - x[3] * c0;
+      adjugate[10] = x[12] * s4 - x[13] * s2 + x[15] * s0;
+      adjugate[11] = -x[8] * s4 + x[9] * s2 - x[11] * s0;
+      adjugate[12] = -x[4] * c3 + x[5] * c1 - x[6] * c0;
+      adjugate[13] = x[0] * c3 - x[1] * c1 + x[2] * c0;
+      adjugate[14] = -x[12] * s3 + x[13] * s1 - x[14] * s0;
+      adjugate[15] = x[8] * s3 - x[9] * s1 + x[10] * s0;
+    }
+  }
+}
+
+// matrices larger than BATCH_UNROLLED are gathered into scratch one by one
+static void batch_general_lane(const batch_job_t *job, int lane,
+                               char inverse) {
+  matrix_arena_mark_t mark = arena_mark(matrix_scratch());
+  int n = job->rows, stride = job->blocks * MATRIX_BATCH_LANES;
+  matrix_t m = allocate_matrix(matrix_scratch(), n, n);
+  matrix_t out = allocate_matrix(matrix_scratch(), n, n);
+  char state = m.matrix && out.matrix;
+
+  for (int e = 0; state && e < n * n; e++) {
+    m.data[e] = job->a[(size_t)e * stride + lane];
+  }
+  if (state && inverse) {
+    state = calculate_LU_inverse(m, &out);
+    for (int e = 0; e < n * n; e++) {
+      job->res[(size_t)e * stride + lane] = state ? out.data[e] : NAN;
+    }
+  } else {
+    job->res[lane] = state ? calculate_view_determinant(view_matrix(&m)) : NAN;
+  }
+  arena_reset(matrix_scratch(), mark);
+}
+
+static inline __attribute__((always_inline)) void batch_determinant_body(
+    void *arg, int begin, int end) {
+  const batch_job_t *job = (const batch_job_t *)arg;
+  batch_lanes_t x[BATCH_UNROLLED * BATCH_UNROLLED], det;
+
+  for (int block = begin; block < end; block++) {
+    if (job->rows <= BATCH_UNROLLED) {
+      batch_load(job, block, x);
+      batch_small_inverse(x, job->rows, &det, NULL);
+      ((batch_lanes_t *)job->res)[block] = det;
+    } else {
+      int lane = block * MATRIX_BATCH_LANES;
+      for (int l = 0; l < MATRIX_BATCH_LANES && lane + l < job->count; l++) {
+        batch_general_lane(job, lane + l, 0);
+      }
+    }
+  }
+}
+
+static inline __attribute__((always_inline)) void batch_inverse_body(
+    void *arg, int begin, int end) {
+  const batch_job_t *job = (const batch_job_t *)arg;
+  batch_lanes_t x[BATCH_UNROLLED * BATCH_UNROLLED], det;
+  batch_lanes_t y[BATCH_UNROLLED * BATCH_UNROLLED];
+  batch_lanes_t *res = (batch_lanes_t *)job->res;
+  int n = job->rows, stride = job->blocks * MATRIX_BATCH_LANES;
+
+  for (int block = begin; block < end; block++) {
+    int lane = block * MATRIX_BATCH_LANES;
+    if (n <= BATCH_UNROLLED) {
+      batch_load(job, block, x);
+      batch_small_inverse(x, n, &det, y);
+      batch_lanes_t inverse_det = 1.0 / det;
+      for (int e = 0; e < n * n; e++) {
+        res[(size_t)e * job->blocks + block] = y[e] * inverse_det;
+      }
+      // singular lanes are marked, not the whole batch failed
+      for (int l = 0; l < MATRIX_BATCH_LANES && lane + l < job->count; l++) {
+        for (int e = 0; fabs(det[l]) < ACCURACY && e < n * n; e++) {
+          job->res[(size_t)e * stride + lane + l] = NAN;
+        }
+      }
+    } else {
+      for (int l = 0; l < MATRIX_BATCH_LANES && lane + l < job->count; l++) {
+        batch_general_lane(job, lane + l, 1);
+      }
+    }
+  }
+}
+
+static inline __attribute__((always_inline)) void batch_product_body(
+    void *arg, int begin, int end) {
+  const batch_job_t *job = (const batch_job_t *)arg;
+  const batch_lanes_t *a = (const batch_lanes_t *)job->a;
+  const batch_lanes_t *b = (const batch_lanes_t *)job->b;
+  batch_lanes_t *res = (batch_lanes_t *)job->res;
+  size_t blocks = job->blocks;
+
+  for (int block = begin; block < end; block++) {
+    for (int i = 0; i < job->rows; i++) {
+      for (int j = 0; j < job->columns; j++) {
+        batch_lanes_t sum = {0};
+        for (int p = 0; p < job->inner; p++) {
+          sum += a[(i * job->inner + p) * blocks + block] *
+                 b[(p * job->columns + j) * blocks + block];
+        }
+        res[(i * job->columns + j) * blocks + block] = sum;
+      }
+    }
+  }
+}
+
+static void batch_determinant_task(void *arg, int begin, int end) {
+  batch_determinant_body(arg, begin, end);
+}
+
+static void batch_inverse_task(void *arg, int begin, int end) {
+  batch_inverse_body(arg, begin, end);
+}
+
+static void batch_product_task(void *arg, int begin, int end) {
+  batch_product_body(arg, begin, end);
+}
+
+#ifdef BATCH_X86
+__attribute__((target("avx2"))) static void batch_determinant_task_avx2(
+    void *arg, int begin, int end) {
+  batch_determinant_body(arg, begin, end);
+}
+
+__attribute__((target("avx2"))) static void batch_inverse_task_avx2(
+    void *arg, int begin, int end) {
+  batch_inverse_body(arg, begin, end);
+}
+
+__attribute__((target("avx2"))) static void batch_product_task_avx2(
+    void *arg, int begin, int end) {
+  batch_product_body(arg, begin, end);
+}
+#endif
+
+static batch_tasks_t batch_tasks = {batch_determinant_task, batch_inverse_task,
+                                    batch_product_task};
+
+#ifdef BATCH_X86
+// chosen before main() like matrix_kernels, so batch calls only read it
+__attribute__((constructor)) static void batch_select_tasks(void) {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    batch_tasks = (batch_tasks_t){batch_determinant_task_avx2,
+                                  batch_inverse_task_avx2,
+                                  batch_product_task_avx2};
+  }
+}
+#endif
+
+static void batch_sum_task(void *arg, int begin, int end) {
+  const batch_job_t *job = (const batch_job_t *)arg;
+  size_t stride = (size_t)job->blocks * MATRIX_BATCH_LANES;
+
+  matrix_kernels.add(job->a + begin * stride, job->b + begin * stride,
+                     job->res + begin * stride, (end - begin) * stride);
+}
+
+// blocks of lanes worth a task: MATRIX_PARALLEL_GRAIN elements
+static int batch_grain(int elements) {
+  return MATRIX_PARALLEL_GRAIN / MATRIX_BATCH_LANES / elements + 1;
+}
+
+matrix_batch_t create_batch(int count, int rows, int columns) {
+  matrix_batch_t batch;
+
+  batch = allocate_batch(count, rows, columns);
+  if (batch.data) {
+    memset(batch.data, 0, sizeof(double) * rows * columns * batch.stride);
+  }
+
+  return batch;
+}
+
+void remove_batch(matrix_batch_t *batch) {
+  if (batch) {
+    matrix_free(batch->data);
+    batch_error(batch);
+  }
+}
+
+int batch_set(matrix_batch_t *batch, int index, matrix_t *a) {
+  char state = 0;
+
+  state = base_check_matrices(a, NULL);
+  state = state && batch && batch->data && index >= 0 &&
+          index < batch->count && a->rows == batch->rows &&
+          a->columns == batch->columns;
+  for (int i = 0; state && i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      batch->data[(size_t)(i * a->columns + j) * batch->stride + index] =
+          a->matrix[i][j];
+    }
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+matrix_t batch_get(matrix_batch_t *batch, int index) {
+  matrix_t matrix;
+
+  if (batch && batch->data && index >= 0 && index < batch->count) {
+    matrix = allocate_matrix(get_matrix_arena(), batch->rows, batch->columns);
+    for (int e = 0; matrix.matrix && e < batch->rows * batch->columns; e++) {
+      matrix.data[e] = batch->data[(size_t)e * batch->stride + index];
+    }
+  } else {
+    matrix_error(&matrix);
+  }
+
+  return matrix;
+}
+
+int batch_determinant(matrix_batch_t *a, double *result) {
+  matrix_arena_mark_t mark = arena_mark(matrix_scratch());
+  double *lanes = NULL;
+  char state = 0;
+
+  state = check_batch(a) && a->rows == a->columns && result != NULL;
+  if (state) {
+    lanes = (double *)arena_alloc(matrix_scratch(), sizeof(double) * a->stride);
+    state = lanes != NULL;
+  }
+  if (state) {
+    batch_job_t job = {.a = a->data,
+                       .res = lanes,
+                       .rows = a->rows,
+                       .columns = a->rows,
+                       .count = a->count,
+                       .blocks = a->stride / MATRIX_BATCH_LANES};
+    parallel_for(job.blocks, batch_grain(a->rows * a->rows),
+                 batch_tasks.determinant, &job);
+    memcpy(result, lanes, sizeof(double) * a->count);
+  }
+  arena_reset(matrix_scratch(), mark);
+
+  return state ? SUCCESS : FAILURE;
+}
+
+matrix_batch_t batch_inverse(matrix_batch_t *a) {
+  matrix_batch_t batch;
+
+  batch_error(&batch);
+  if (check_batch(a) && a->rows == a->columns) {
+    batch = allocate_batch(a->count, a->rows, a->columns);
+  }
+  if (batch.data) {
+    batch_job_t job = {.a = a->data,
+                       .res = batch.data,
+                       .rows = a->rows,
+                       .columns = a->rows,
+                       .count = a->count,
+                       .blocks = a->stride / MATRIX_BATCH_LANES};
+    parallel_for(job.blocks, batch_grain(a->rows * a->rows),
+                 batch_tasks.inverse, &job);
+  }
+
+  return batch;
+}
+
+matrix_batch_t batch_mult(matrix_batch_t *a, matrix_batch_t *b) {
+  matrix_batch_t batch;
+
+  batch_error(&batch);
+  if (check_batch(a) && check_batch(b) && a->count == b->count &&
+      a->columns == b->rows) {
+    batch = allocate_batch(a->count, a->rows, b->columns);
+  }
+  if (batch.data) {
+    batch_job_t job = {.a = a->data,
+                       .b = b->data,
+                       .res = batch.data,
+                       .rows = a->rows,
+                       .columns = b->columns,
+                       .inner = a->columns,
+                       .count = a->count,
+                       .blocks = a->stride / MATRIX_BATCH_LANES};
+    parallel_for(job.blocks, batch_grain(a->rows * b->columns * a->columns),
+                 batch_tasks.product, &job);
+  }
+
+  return batch;
+}
+
+matrix_batch_t batch_sum(matrix_batch_t *a, matrix_batch_t *b) {
+  matrix_batch_t batch;
+
+  batch_error(&batch);
+  if (check_batch(a) && check_batch(b) && a->count == b->count &&
+      a->rows == b->rows && a->columns == b->columns) {
+    batch = allocate_batch(a->count, a->rows, a->columns);
+  }
+  if (batch.data) {
+    batch_job_t job = {.a = a->data,
+                       .b = b->data,
+                       .res = batch.data,
+                       .rows = a->rows,
+                       .columns = a->columns,
+                       .count = a->count,
+                       .blocks = a->stride / MATRIX_BATCH_LANES};
+    parallel_for(a->rows * a->columns, elementwise_grain(a->stride),
+                 batch_sum_task, &job);
+  }
+
+  return batch;
+}
+
+matrix_batch_t allocate_batch(int count, int rows, int columns) {
+  matrix_batch_t batch;
+
+  batch_error(&batch);
+  if (count > 0 && rows > 0 && columns > 0) {
+    int stride = (count + MATRIX_BATCH_LANES - 1) / MATRIX_BATCH_LANES *
+                 MATRIX_BATCH_LANES;
+    batch.data =
+        (double *)matrix_alloc(sizeof(double) * rows * columns * stride);
+    if (batch.data) {
+      batch.count = count;
+      batch.rows = rows;
+      batch.columns = columns;
+      batch.stride = stride;
+    }
+  }
+
+  return batch;
+}
+
+void batch_error(matrix_batch_t *batch) {
+  batch->data = NULL;
+  batch->count = 0;
+  batch->rows = 0;
+  batch->columns = 0;
+  batch->stride = 0;
+}
+
+char check_batch(matrix_batch_t *a) {
+  matrix_validation_t policy = get_matrix_validation();
+  char state = a && a->data && a->count > 0 && a->rows > 0 && a->columns > 0;
+
+#ifdef NDEBUG
+  if (policy == VALIDATION_DEBUG) policy = VALIDATION_TRUSTED;
+#endif
+  // padding lanes are not scanned, results leave them unspecified
+  for (int e = 0; state && policy != VALIDATION_TRUSTED &&
+                  e < a->rows * a->columns;
+       e++) {
+    state = !has_nan(a->data + (size_t)e * a->stride, a->count);
+  }
+
+  return state;
+}
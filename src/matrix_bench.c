@@ -0,0 +1,244 @@
+#include <time.h>
+
+#include "matrix.h"
+
+// sample lasts at least this long so timer resolution does not matter
+#define BENCH_MIN_SAMPLE_NS 20000.0
+#define BENCH_MAX_SAMPLES 1000
+
+typedef struct bench_options_struct {
+  int max_size;
+  int min_runs;
+  double budget;  // seconds spent on one case at most
+} bench_options_t;
+
+typedef enum {
+  BENCH_CREATE = 0,
+  BENCH_SUM = 1,
+  BENCH_MULT = 2,
+  BENCH_TRANSPOSE = 3,
+  BENCH_DETERMINANT = 4,
+  BENCH_COMPLEMENTS = 5,
+  BENCH_INVERSE = 6
+} bench_function_t;
+
+static const char *bench_names[] = {
+    "create_matrix", "sum_matrix",       "mult_matrix",   "transpose",
+    "determinant",   "calc_complements", "inverse_matrix"};
+
+typedef struct bench_case_struct {
+  bench_function_t function;
+  int rows;
+  int columns;
+  int inner;  // shared dimension of mult_matrix, 0 otherwise
+  matrix_t a;
+  matrix_t b;
+  double flop;  // floating point operations in one call
+} bench_case_t;
+
+static double bench_now(void) {
+  struct timespec ts;
+
+  timespec_get(&ts, TIME_UTC);
+
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void bench_fill(matrix_t *m, int seed) {
+  unsigned state = 2463534242u + seed;
+
+  for (int i = 0; i < m->rows; i++) {
+    for (int j = 0; j < m->columns; j++) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      m->matrix[i][j] = (double)(state % 2001) / 1000.0 - 1.0;
+    }
+    if (i < m->columns) m->matrix[i][i] += 2.0;
+  }
+  m->matrix_type = CORRECT_MATRIX;
+}
+
+static void bench_call(bench_case_t *c) {
+  volatile double det = 0.0;
+  matrix_t res = {0};
+
+  switch (c->function) {
+    case BENCH_CREATE:
+      res = create_matrix(c->rows, c->columns);
+      break;
+    case BENCH_SUM:
+      res = sum_matrix(&c->a, &c->b);
+      break;
+    case BENCH_MULT:
+      res = mult_matrix(&c->a, &c->b);
+      break;
+    case BENCH_TRANSPOSE:
+      res = transpose(&c->a);
+      break;
+    case BENCH_DETERMINANT:
+      det = determinant(&c->a);
+      break;
+    case BENCH_COMPLEMENTS:
+      res = calc_complements(&c->a);
+      break;
+    case BENCH_INVERSE:
+      res = inverse_matrix(&c->a);
+      break;
+  }
+  (void)det;
+  remove_matrix(&res);
+}
+
+static int bench_compare(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+
+  return (x > y) - (x < y);
+}
+
+static void bench_run(bench_case_t *c, bench_options_t *options) {
+  static int first = 1;
+  static double samples[BENCH_MAX_SAMPLES];
+  double start = 0.0, spent = 0.0, call_ns = 0.0;
+  matrix_alloc_stats_t before, after;
+  int batch = 1, runs = 0;
+
+  // one warm-up call measures allocations and sizes the batch
+  before = get_matrix_alloc_stats();
+  start = bench_now();
+  bench_call(c);
+  call_ns = bench_now() - start;
+  after = get_matrix_alloc_stats();
+  if (call_ns < BENCH_MIN_SAMPLE_NS) {
+    batch = (int)(BENCH_MIN_SAMPLE_NS / (call_ns > 1.0 ? call_ns : 1.0)) + 1;
+  }
+  while (runs < BENCH_MAX_SAMPLES &&
+         (runs < options->min_runs || spent < options->budget * 1e9)) {
+    start = bench_now();
+    for (int i = 0; i < batch; i++) bench_call(c);
+    samples[runs] = (bench_now() - start) / batch;
+    spent += samples[runs++] * batch;
+  }
+  qsort(samples, runs, sizeof(double), bench_compare);
+
+  double median = samples[runs / 2];
+  double p99 = samples[(int)((runs - 1) * 0.99 + 0.5)];
+  printf("%s    {\"function\": \"%s\", \"rows\": %d, \"columns\": %d, "
+         "\"inner\": %d, \"runs\": %d, \"median_ns\": %.1f, "
+         "\"p99_ns\": %.1f, ",
+         first ? "" : ",\n", bench_names[c->function], c->rows, c->columns,
+         c->inner, runs * batch, median, p99);
+  if (c->flop > 0) {
+    printf("\"gflops\": %.3f, ", c->flop / median);
+  } else {
+    printf("\"gflops\": null, ");
+  }
+  printf("\"bytes_allocated\": %zu, \"allocations\": %zu}",
+         after.bytes - before.bytes, after.allocations - before.allocations);
+  fflush(stdout);
+  first = 0;
+}
+
+static void bench_case(bench_function_t function, int rows, int columns,
+                       int inner, bench_options_t *options) {
+  bench_case_t c = {function, rows, columns, inner, {0}, {0}, 0.0};
+  double n = rows;
+
+  if (function == BENCH_SUM) {
+    c.flop = (double)rows * columns;
+  } else if (function == BENCH_MULT) {
+    c.flop = 2.0 * rows * columns * inner;
+  } else if (function == BENCH_DETERMINANT) {
+    c.flop = 2.0 / 3.0 * n * n * n;
+  } else if (function == BENCH_COMPLEMENTS || function == BENCH_INVERSE) {
+    c.flop = 2.0 * n * n * n;
+  }
+  if (function != BENCH_CREATE) {
+    c.a = create_matrix(rows, inner ? inner : columns);
+    bench_fill(&c.a, 1);
+  }
+  if (function == BENCH_SUM || function == BENCH_MULT) {
+    c.b = create_matrix(inner ? inner : rows, columns);
+    bench_fill(&c.b, 2);
+  }
+  bench_run(&c, options);
+  remove_matrix(&c.a);
+  remove_matrix(&c.b);
+}
+
+// one product with Strassen-Winograd recursion two levels deep against the
+// classic blocked GEMM: speed and largest difference relative to largest
+// element of the classic result
+static void bench_strassen(int n, int first) {
+  matrix_t a = create_matrix(n, n), b = create_matrix(n, n), c, s;
+  double start = 0.0, classic_ns = 0.0, strassen_ns = 0.0;
+  double difference = 0.0, largest = 0.0;
+  matrix_product_t algorithm = get_matrix_product();
+  int cutoff = get_strassen_cutoff();
+
+  bench_fill(&a, 1);
+  bench_fill(&b, 2);
+  set_matrix_product(PRODUCT_CLASSIC);
+  start = bench_now();
+  c = mult_matrix(&a, &b);
+  classic_ns = bench_now() - start;
+  set_matrix_product(PRODUCT_AUTO);
+  set_strassen_cutoff(n / 4);
+  start = bench_now();
+  s = mult_matrix(&a, &b);
+  strassen_ns = bench_now() - start;
+  for (int i = 0; c.matrix && s.matrix && i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      double d = fabs(c.matrix[i][j] - s.matrix[i][j]);
+      if (d > difference) difference = d;
+      if (fabs(c.matrix[i][j]) > largest) largest = fabs(c.matrix[i][j]);
+    }
+  }
+  printf("%s    {\"size\": %d, \"cutoff\": %d, \"classic_ns\": %.1f, "
+         "\"strassen_ns\": %.1f, \"relative_error\": %.3e}",
+         first ? "" : ",\n", n, n / 4, classic_ns, strassen_ns,
+         largest > 0.0 ? difference / largest : difference);
+  fflush(stdout);
+  set_matrix_product(algorithm);
+  set_strassen_cutoff(cutoff);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+  remove_matrix(&s);
+}
+
+int main(int argc, char **argv) {
+  static const int sizes[] = {2,   3,   4,   8,    16,   32,  64,
+                              128, 256, 512, 1024, 2048, 4096};
+  bench_options_t options = {4096, 3, 0.25};
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--max-size")) options.max_size = atoi(argv[i + 1]);
+    if (!strcmp(argv[i], "--min-runs")) options.min_runs = atoi(argv[i + 1]);
+    if (!strcmp(argv[i], "--budget")) options.budget = atof(argv[i + 1]);
+    if (!strcmp(argv[i], "--cache")) {
+      set_matrix_cache_limit(strtoull(argv[i + 1], NULL, 10));
+    }
+  }
+  printf("{\n  \"simd\": \"%s\",\n  \"results\": [\n", matrix_simd_level());
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(int); s++) {
+    int n = sizes[s], skew = n / 8;
+    if (n > options.max_size) continue;
+    for (int f = BENCH_CREATE; f <= BENCH_INVERSE; f++) {
+      bench_case(f, n, n, f == BENCH_MULT ? n : 0, &options);
+    }
+    // skewed shapes: tall-skinny operands and outer/inner products
+    if (skew > 0) {
+      bench_case(BENCH_CREATE, n, skew, 0, &options);
+      bench_case(BENCH_SUM, n, skew, 0, &options);
+      bench_case(BENCH_TRANSPOSE, n, skew, 0, &options);
+      bench_case(BENCH_MULT, n, n, skew, &options);
+      bench_case(BENCH_MULT, skew, skew, n, &options);
+    }
+  }
+  printf("\n  ],\n  \"strassen\": [\n");
+  for (int n = 256; n <= options.max_size; n *= 2) bench_strassen(n, n == 256);
+  printf("\n  ]\n}\n");
+
+  return 0;
+}
@@ -0,0 +1,215 @@
+#include "matrix.h"
+
+mat2_t mat2_mult(const mat2_t *a, const mat2_t *b) {
+  mat2_t res;
+
+  res.m[0][0] = a->m[0][0] * b->m[0][0] + a->m[0][1] * b->m[1][0];
+  res.m[0][1] = a->m[0][0] * b->m[0][1] + a->m[0][1] * b->m[1][1];
+  res.m[1][0] = a->m[1][0] * b->m[0][0] + a->m[1][1] * b->m[1][0];
+  res.m[1][1] = a->m[1][0] * b->m[0][1] + a->m[1][1] * b->m[1][1];
+
+  return res;
+}
+
+mat3_t mat3_mult(const mat3_t *a, const mat3_t *b) {
+  mat3_t res;
+
+  // rows of result are combinations of rows of "b", so inner loop is a row
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      res.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] +
+                    a->m[i][2] * b->m[2][j];
+    }
+  }
+
+  return res;
+}
+
+mat4_t mat4_mult(const mat4_t *a, const mat4_t *b) {
+  mat4_t res;
+
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      res.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] +
+                    a->m[i][2] * b->m[2][j] + a->m[i][3] * b->m[3][j];
+    }
+  }
+
+  return res;
+}
+
+double mat2_determinant(const mat2_t *a) {
+  return a->m[0][0] * a->m[1][1] - a->m[1][0] * a->m[0][1];
+}
+
+double mat3_determinant(const mat3_t *a) {
+  return a->m[0][0] * (a->m[1][1] * a->m[2][2] - a->m[2][1] * a->m[1][2]) -
+         a->m[0][1] * (a->m[1][0] * a->m[2][2] - a->m[2][0] * a->m[1][2]) +
+         a->m[0][2] * (a->m[1][0] * a->m[2][1] - a->m[2][0] * a->m[1][1]);
+}
+
+double mat4_determinant(const mat4_t *a) {
+  double s[6], c[6];
+
+  mat4_minors(a, s, c);
+
+  return s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] -
+         s[4] * c[1] + s[5] * c[0];
+}
+
+int mat2_inverse(const mat2_t *a, mat2_t *res) {
+  double det = mat2_determinant(a);
+  char state = fabs(det) >= ACCURACY;
+
+  if (state) {
+    double inverse_det = 1.0 / det, a00 = a->m[0][0];
+    res->m[0][0] = a->m[1][1] * inverse_det;
+    res->m[0][1] = -a->m[0][1] * inverse_det;
+    res->m[1][0] = -a->m[1][0] * inverse_det;
+    res->m[1][1] = a00 * inverse_det;
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+int mat3_inverse(const mat3_t *a, mat3_t *res) {
+  mat3_t cofactors;
+  double det = 0.0;
+  char state = 0;
+
+  // cyclic indices give cofactor sign
+  for (int i = 0; i < 3; i++) {
+    int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+    for (int j = 0; j < 3; j++) {
+      int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+      cofactors.m[i][j] = a->m[i1][j1] * a->m[i2][j2] -
+                          a->m[i1][j2] * a->m[i2][j1];
+    }
+  }
+  det = a->m[0][0] * cofactors.m[0][0] + a->m[0][1] * cofactors.m[0][1] +
+        a->m[0][2] * cofactors.m[0][2];
+  state = fabs(det) >= ACCURACY;
+  for (int i = 0; state && i < 3; i++) {
+    for (int j = 0; j < 3; j++) res->m[i][j] = cofactors.m[j][i] / det;
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+int mat4_inverse(const mat4_t *a, mat4_t *res) {
+  const double(*x)[4] = a->m;
+  double s[6], c[6], det = 0.0, b[4][4];
+  char state = 0;
+
+  mat4_minors(a, s, c);
+  det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] +
+        s[5] * c[0];
+  state = fabs(det) >= ACCURACY;
+  if (state) {
+    // adjugate from the same 2x2 minors; "res" may be the same as "a"
+    b[0][0] = x[1][1] * c[5] - x[1][2] * c[4] + x[1][3] * c[3];
+    b[0][1] = -x[0][1] * c[5] + x[0][2] * c[4] - x[0][3] * c[3];
+    b[0][2] = x[3][1] * s[5] - x[3][2] * s[4] + x[3][3] * s[3];
+    b[0][3] = -x[2][1] * s[5] + x[2][2] * s[4] - x[2][3] * s[3];
+    b[1][0] = -x[1][0] * c[5] + x[1][2] * c[2] - x[1][3] * c[1];
+    b[1][1] = x[0][0] * c[5] - x[0][2] * c[2] + x[0][3] * c[1];
+    b[1][2] = -x[3][0] * s[5] + x[3][2] * s[2] - x[3][3] * s[1];
+    b[1][3] = x[2][0] * s[5] - x[2][2] * s[2] + x[2][3] * s[1];
+    b[2][0] = x[1][0] * c[4] - x[1][1] * c[2] + x[1][3] * c[0];
+    b[2][1] = -x[0][0] * c[4] + x[0][1] * c[2] - x[0][3] * c[0];
+    b[2][2] = x[3][0] * s[4] - x[3][1] * s[2] + x[3][3] * s[0];
+    b[2][3] = -x[2][0] * s[4] + x[2][1] * s[2] - x[2][3] * s[0];
+    b[3][0] = -x[1][0] * c[3] + x[1][1] * c[1] - x[1][2] * c[0];
+    b[3][1] = x[0][0] * c[3] - x[0][1] * c[1] + x[0][2] * c[0];
+    b[3][2] = -x[3][0] * s[3] + x[3][1] * s[1] - x[3][2] * s[0];
+    b[3][3] = x[2][0] * s[3] - x[2][1] * s[1] + x[2][2] * s[0];
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 4; j++) res->m[i][j] = b[i][j] / det;
+    }
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+mat2_t mat2_transpose(const mat2_t *a) {
+  mat2_t res = {{{a->m[0][0], a->m[1][0]}, {a->m[0][1], a->m[1][1]}}};
+
+  return res;
+}
+
+mat3_t mat3_transpose(const mat3_t *a) {
+  mat3_t res;
+
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) res.m[i][j] = a->m[j][i];
+  }
+
+  return res;
+}
+
+mat4_t mat4_transpose(const mat4_t *a) {
+  mat4_t res;
+
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) res.m[i][j] = a->m[j][i];
+  }
+
+  return res;
+}
+
+int mat2_from_matrix(matrix_t *a, mat2_t *res) {
+  return copy_to_fixed(a, 2, res ? res->m[0] : NULL);
+}
+
+int mat3_from_matrix(matrix_t *a, mat3_t *res) {
+  return copy_to_fixed(a, 3, res ? res->m[0] : NULL);
+}
+
+int mat4_from_matrix(matrix_t *a, mat4_t *res) {
+  return copy_to_fixed(a, 4, res ? res->m[0] : NULL);
+}
+
+matrix_t mat2_to_matrix(const mat2_t *a) { return copy_from_fixed(a->m[0], 2); }
+
+matrix_t mat3_to_matrix(const mat3_t *a) { return copy_from_fixed(a->m[0], 3); }
+
+matrix_t mat4_to_matrix(const mat4_t *a) { return copy_from_fixed(a->m[0], 4); }
+
+void mat4_minors(const mat4_t *a, double s[6], double c[6]) {
+  const double(*x)[4] = a->m;
+
+  // 2x2 minors of the upper ("s") and lower ("c") row pairs
+  s[0] = x[0][0] * x[1][1] - x[1][0] * x[0][1];
+  s[1] = x[0][0] * x[1][2] - x[1][0] * x[0][2];
+  s[2] = x[0][0] * x[1][3] - x[1][0] * x[0][3];
+  s[3] = x[0][1] * x[1][2] - x[1][1] * x[0][2];
+  s[4] = x[0][1] * x[1][3] - x[1][1] * x[0][3];
+  s[5] = x[0][2] * x[1][3] - x[1][2] * x[0][3];
+  c[5] = x[2][2] * x[3][3] - x[3][2] * x[2][3];
+  c[4] = x[2][1] * x[3][3] - x[3][1] * x[2][3];
+  c[3] = x[2][1] * x[3][2] - x[3][1] * x[2][2];
+  c[2] = x[2][0] * x[3][3] - x[3][0] * x[2][3];
+  c[1] = x[2][0] * x[3][2] - x[3][0] * x[2][2];
+  c[0] = x[2][0] * x[3][1] - x[3][0] * x[2][1];
+}
+
+int copy_to_fixed(matrix_t *a, int n, double *res) {
+  char state = 0;
+
+  state = base_check_matrices(a, NULL);
+  state = state && res && a->rows == n && a->columns == n;
+  for (int i = 0; state && i < n; i++) {
+    memcpy(res + i * n, a->matrix[i], sizeof(double) * n);
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+matrix_t copy_from_fixed(const double *a, int n) {
+  matrix_t matrix;
+
+  matrix = allocate_matrix(get_matrix_arena(), n, n);
+  if (matrix.matrix) memcpy(matrix.data, a, sizeof(double) * n * n);
+
+  return matrix;
+}
@@ -0,0 +1,281 @@
+#ifndef SRC_S21_MATRIX_FIXED_HPP_
+#define SRC_S21_MATRIX_FIXED_HPP_
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "matrix.hpp"
+
+namespace s21 {
+namespace fixed {
+
+// square sizes up to this one expand determinants by cofactors, like
+// calculate_2d_determinant() and calculate_3d_determinant() do by hand;
+// bigger ones use elimination
+constexpr int kCofactorLimit = 4;
+
+// R x C matrix with sizes known at compile time: elements live in the object
+// itself, products of mismatched sizes do not compile and every operation is
+// usable in constant expressions
+template <int R, int C, class T = double>
+class Matrix {
+  static_assert(R > 0 && C > 0, "matrix size must be positive");
+  static_assert(std::is_floating_point_v<T>, "elements must be floating");
+
+ public:
+  constexpr Matrix() : data_() {}
+
+  // Matrix<2, 2> m({{1, 2}, {3, 4}});
+  constexpr explicit Matrix(const T (&rows)[R][C]) : data_() {
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) (*this)(i, j) = rows[i][j];
+    }
+  }
+
+  static constexpr Matrix Identity() {
+    static_assert(R == C, "identity matrix must be square");
+    Matrix matrix;
+    for (int i = 0; i < R; i++) matrix(i, i) = T(1);
+    return matrix;
+  }
+
+  /**
+   * @brief Copies matrix of the same size out of the heap
+   *
+   * @throw std::invalid_argument when size differs
+   */
+  static Matrix FromMatrix(const s21::Matrix &other) {
+    Matrix matrix;
+    if (other.Rows() != R || other.Columns() != C) {
+      throw std::invalid_argument("matrix sizes differ");
+    }
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) matrix(i, j) = T(other(i, j));
+    }
+    return matrix;
+  }
+
+  s21::Matrix ToMatrix() const {
+    s21::Matrix matrix(R, C);
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) matrix(i, j) = double((*this)(i, j));
+    }
+    return matrix;
+  }
+
+  static constexpr int Rows() { return R; }
+  static constexpr int Columns() { return C; }
+
+  constexpr T &operator()(int row, int column) {
+    return data_[static_cast<std::size_t>(row) * C + column];
+  }
+  constexpr const T &operator()(int row, int column) const {
+    return data_[static_cast<std::size_t>(row) * C + column];
+  }
+
+  // elements are equal up to ACCURACY, as in eq_matrix()
+  constexpr bool operator==(const Matrix &other) const {
+    bool equal = true;
+    for (std::size_t k = 0; equal && k < data_.size(); k++) {
+      T difference = data_[k] - other.data_[k];
+      equal = difference < T(ACCURACY) && -difference < T(ACCURACY);
+    }
+    return equal;
+  }
+  constexpr bool operator!=(const Matrix &other) const {
+    return !(*this == other);
+  }
+
+  constexpr Matrix &operator+=(const Matrix &other) {
+    for (std::size_t k = 0; k < data_.size(); k++) data_[k] += other.data_[k];
+    return *this;
+  }
+  constexpr Matrix &operator-=(const Matrix &other) {
+    for (std::size_t k = 0; k < data_.size(); k++) data_[k] -= other.data_[k];
+    return *this;
+  }
+  constexpr Matrix &operator*=(T number) {
+    for (std::size_t k = 0; k < data_.size(); k++) data_[k] *= number;
+    return *this;
+  }
+
+  friend constexpr Matrix operator+(Matrix a, const Matrix &b) {
+    return a += b;
+  }
+  friend constexpr Matrix operator-(Matrix a, const Matrix &b) {
+    return a -= b;
+  }
+  friend constexpr Matrix operator*(Matrix a, T number) { return a *= number; }
+  friend constexpr Matrix operator*(T number, Matrix a) { return a *= number; }
+
+  constexpr Matrix<C, R, T> Transpose() const {
+    Matrix<C, R, T> matrix;
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) matrix(j, i) = (*this)(i, j);
+    }
+    return matrix;
+  }
+
+  // matrix without row "row" and column "column"
+  constexpr Matrix<R - 1, C - 1, T> Minor(int row, int column) const {
+    static_assert(R > 1 && C > 1, "minor of a single row or column");
+    Matrix<R - 1, C - 1, T> matrix;
+    for (int i = 0; i < R - 1; i++) {
+      for (int j = 0; j < C - 1; j++) {
+        matrix(i, j) = (*this)(i + (i >= row), j + (j >= column));
+      }
+    }
+    return matrix;
+  }
+
+  constexpr T Determinant() const {
+    static_assert(R == C, "determinant of a non-square matrix");
+    const Matrix &a = *this;
+    T returnable = T(0);
+
+    if constexpr (R == 1) {
+      returnable = a(0, 0);
+    } else if constexpr (R == 2) {
+      returnable = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+    } else if constexpr (R == 3) {
+      returnable = a(0, 0) * (a(1, 1) * a(2, 2) - a(2, 1) * a(1, 2)) -
+                   a(0, 1) * (a(1, 0) * a(2, 2) - a(2, 0) * a(1, 2)) +
+                   a(0, 2) * (a(1, 0) * a(2, 1) - a(2, 0) * a(1, 1));
+    } else if constexpr (R <= kCofactorLimit) {
+      // expansion along the first row, minors are unrolled recursively
+      for (int j = 0; j < C; j++) {
+        T term = a(0, j) * a.Minor(0, j).Determinant();
+        returnable += j % 2 ? -term : term;
+      }
+    } else {
+      returnable = Eliminated().Determinant();
+    }
+
+    return returnable;
+  }
+
+  /**
+   * @brief Inverse matrix by adjugate up to kCofactorLimit and by Gaussian
+   * elimination with back substitution above it
+   *
+   * @throw std::invalid_argument when determinant is less than ACCURACY
+   */
+  constexpr Matrix Inverse() const {
+    static_assert(R == C, "inverse of a non-square matrix");
+    Matrix matrix;
+
+    if constexpr (R <= kCofactorLimit) {
+      T det = Determinant();
+      CheckInvertible(det);
+      if constexpr (R == 1) {
+        matrix(0, 0) = T(1) / det;
+      } else {
+        for (int i = 0; i < R; i++) {
+          for (int j = 0; j < C; j++) {
+            T cofactor = Minor(i, j).Determinant() / det;
+            matrix(j, i) = (i + j) % 2 ? -cofactor : cofactor;
+          }
+        }
+      }
+    } else {
+      matrix = Identity();
+      Elimination elimination = Eliminated(&matrix);
+      CheckInvertible(elimination.Determinant());
+      // back substitution with the upper triangle
+      for (int i = R - 1; i >= 0; i--) {
+        for (int j = 0; j < C; j++) {
+          T sum = matrix(i, j);
+          for (int k = i + 1; k < R; k++) {
+            sum -= elimination.left(i, k) * matrix(k, j);
+          }
+          matrix(i, j) = sum / elimination.left(i, i);
+        }
+      }
+    }
+
+    return matrix;
+  }
+
+ private:
+  // upper triangle of P * A after partial pivoting
+  struct Elimination {
+    Matrix left;
+    int sign;
+
+    constexpr T Determinant() const {
+      T returnable = T(sign);
+      for (int i = 0; i < R; i++) returnable *= left(i, i);
+      return returnable;
+    }
+  };
+
+  // "right" is replaced by P * B with the same row operations; determinant
+  // passes none and skips them
+  constexpr Elimination Eliminated(Matrix *right = nullptr) const {
+    Elimination elimination = {*this, 1};
+    Matrix &a = elimination.left;
+
+    for (int k = 0; k < R; k++) {
+      int pivot = k;
+      for (int i = k + 1; i < R; i++) {
+        if (Magnitude(a(i, k)) > Magnitude(a(pivot, k))) pivot = i;
+      }
+      if (pivot != k) {
+        elimination.sign = -elimination.sign;
+        for (int j = 0; j < C; j++) {
+          Swap(a(k, j), a(pivot, j));
+          if (right) Swap((*right)(k, j), (*right)(pivot, j));
+        }
+      }
+      for (int i = k + 1; a(k, k) != T(0) && i < R; i++) {
+        T factor = a(i, k) / a(k, k);
+        for (int j = k; j < C; j++) a(i, j) -= factor * a(k, j);
+        for (int j = 0; right && j < C; j++) {
+          (*right)(i, j) -= factor * (*right)(k, j);
+        }
+      }
+    }
+
+    return elimination;
+  }
+
+  static constexpr T Magnitude(T value) {
+    return value < T(0) ? -value : value;
+  }
+
+  static constexpr void Swap(T &a, T &b) {
+    T swapped = a;
+    a = b;
+    b = swapped;
+  }
+
+  static constexpr void CheckInvertible(T det) {
+    if (Magnitude(det) < T(ACCURACY)) {
+      throw std::invalid_argument("matrix is singular");
+    }
+  }
+
+  std::array<T, static_cast<std::size_t>(R) * C> data_;
+};
+
+// inner sizes have to match at compile time
+template <int R, int K, int C, class T>
+constexpr Matrix<R, C, T> operator*(const Matrix<R, K, T> &a,
+                                    const Matrix<K, C, T> &b) {
+  Matrix<R, C, T> matrix;
+
+  for (int i = 0; i < R; i++) {
+    for (int k = 0; k < K; k++) {
+      for (int j = 0; j < C; j++) matrix(i, j) += a(i, k) * b(k, j);
+    }
+  }
+
+  return matrix;
+}
+
+}  // namespace fixed
+}  // namespace s21
+
+#endif  // SRC_S21_MATRIX_FIXED_HPP_
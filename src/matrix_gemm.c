@@ -0,0 +1,286 @@
+#include <stdatomic.h>
+
+#include "matrix.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_X86 1
+#endif
+
+// register tile: rows of A and columns of B held in accumulators
+#define GEMM_MR 6
+#define GEMM_NR 8
+// cache blocks: A panel MC*KC stays in L2, B micro-panel KC*NR stays in L1
+#define GEMM_MC 96
+#define GEMM_KC 256
+#define GEMM_NC 2048
+// products with m*n*k below this are not worth packing
+#define GEMM_SMALL_VOLUME 32768
+// products with m*n*k below this stay on the calling thread
+#define GEMM_PARALLEL_VOLUME ((double)(1 << 21))
+
+typedef void (*gemm_kernel_t)(int kc, const double *a, const double *b,
+                              double beta, double *c, int ldc, int mr, int nr);
+
+// C = beta * C + alpha * A * B split into row or column stripes of C
+typedef struct gemm_job_struct {
+  int m, n, k;
+  double alpha;
+  const double *a;
+  int rsa, csa;
+  const double *b;
+  int rsb, csb;
+  double beta;
+  double *c;
+  int ldc;
+  int step;  // rows of C per stripe when splitting rows, else columns
+  char split_rows;
+  atomic_int failed;
+} gemm_job_t;
+
+// C = beta * C + AB; zero beta does not read C, so NaN there is dropped
+static void gemm_store_tile(double ab[GEMM_MR][GEMM_NR], double beta,
+                            double *c, int ldc, int mr, int nr) {
+  for (int i = 0; i < mr; i++) {
+    double *c_i = c + (size_t)i * ldc;
+    if (beta == 0.0) {
+      for (int j = 0; j < nr; j++) c_i[j] = ab[i][j];
+    } else if (beta == 1.0) {
+      for (int j = 0; j < nr; j++) c_i[j] += ab[i][j];
+    } else {
+      for (int j = 0; j < nr; j++) c_i[j] = beta * c_i[j] + ab[i][j];
+    }
+  }
+}
+
+static void gemm_kernel_generic(int kc, const double *a, const double *b,
+                                double beta, double *c, int ldc, int mr,
+                                int nr) {
+  double ab[GEMM_MR][GEMM_NR] = {{0}};
+
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < GEMM_MR; i++) {
+      double a_ip = a[i];
+      for (int j = 0; j < GEMM_NR; j++) {
+        ab[i][j] += a_ip * b[j];
+      }
+    }
+    a += GEMM_MR;
+    b += GEMM_NR;
+  }
+  gemm_store_tile(ab, beta, c, ldc, mr, nr);
+}
+
+#ifdef GEMM_X86
+__attribute__((target("avx2,fma"))) static void gemm_kernel_avx2(
+    int kc, const double *a, const double *b, double beta, double *c, int ldc,
+    int mr, int nr) {
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+  for (int p = 0; p < kc; p++) {
+    __m256d b0 = _mm256_load_pd(b), b1 = _mm256_load_pd(b + 4), ai;
+    ai = _mm256_broadcast_sd(a);
+    c00 = _mm256_fmadd_pd(ai, b0, c00);
+    c01 = _mm256_fmadd_pd(ai, b1, c01);
+    ai = _mm256_broadcast_sd(a + 1);
+    c10 = _mm256_fmadd_pd(ai, b0, c10);
+    c11 = _mm256_fmadd_pd(ai, b1, c11);
+    ai = _mm256_broadcast_sd(a + 2);
+    c20 = _mm256_fmadd_pd(ai, b0, c20);
+    c21 = _mm256_fmadd_pd(ai, b1, c21);
+    ai = _mm256_broadcast_sd(a + 3);
+    c30 = _mm256_fmadd_pd(ai, b0, c30);
+    c31 = _mm256_fmadd_pd(ai, b1, c31);
+    ai = _mm256_broadcast_sd(a + 4);
+    c40 = _mm256_fmadd_pd(ai, b0, c40);
+    c41 = _mm256_fmadd_pd(ai, b1, c41);
+    ai = _mm256_broadcast_sd(a + 5);
+    c50 = _mm256_fmadd_pd(ai, b0, c50);
+    c51 = _mm256_fmadd_pd(ai, b1, c51);
+    a += GEMM_MR;
+    b += GEMM_NR;
+  }
+
+  double ab[GEMM_MR][GEMM_NR];
+  _mm256_storeu_pd(ab[0], c00);
+  _mm256_storeu_pd(ab[0] + 4, c01);
+  _mm256_storeu_pd(ab[1], c10);
+  _mm256_storeu_pd(ab[1] + 4, c11);
+  _mm256_storeu_pd(ab[2], c20);
+  _mm256_storeu_pd(ab[2] + 4, c21);
+  _mm256_storeu_pd(ab[3], c30);
+  _mm256_storeu_pd(ab[3] + 4, c31);
+  _mm256_storeu_pd(ab[4], c40);
+  _mm256_storeu_pd(ab[4] + 4, c41);
+  _mm256_storeu_pd(ab[5], c50);
+  _mm256_storeu_pd(ab[5] + 4, c51);
+  gemm_store_tile(ab, beta, c, ldc, mr, nr);
+}
+#endif
+
+static gemm_kernel_t gemm_kernel = gemm_kernel_generic;
+
+#ifdef GEMM_X86
+// chosen before main() like matrix_kernels, so worker threads only read it
+__attribute__((constructor)) static void gemm_select_kernel(void) {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    gemm_kernel = gemm_kernel_avx2;
+  }
+}
+#endif
+
+// alpha is applied while packing, so it costs no extra pass
+static void gemm_pack_a(int mc, int kc, double alpha, const double *a,
+                        int rsa, int csa, double *buf) {
+  for (int ir = 0; ir < mc; ir += GEMM_MR) {
+    int mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+    for (int p = 0; p < kc; p++) {
+      for (int i = 0; i < GEMM_MR; i++) {
+        *buf++ = i < mr ? alpha * a[(size_t)(ir + i) * rsa + (size_t)p * csa]
+                        : 0.0;
+      }
+    }
+  }
+}
+
+static void gemm_pack_b(int kc, int nc, const double *b, int rsb, int csb,
+                        double *buf) {
+  for (int jr = 0; jr < nc; jr += GEMM_NR) {
+    int nr = nc - jr < GEMM_NR ? nc - jr : GEMM_NR;
+    for (int p = 0; p < kc; p++) {
+      for (int j = 0; j < GEMM_NR; j++) {
+        *buf++ = j < nr ? b[(size_t)p * rsb + (size_t)(jr + j) * csb] : 0.0;
+      }
+    }
+  }
+}
+
+static void gemm_scale_row(double *c, int n, double beta) {
+  if (beta == 0.0) {
+    memset(c, 0, sizeof(double) * n);
+  } else if (beta != 1.0) {
+    matrix_kernels.scale(c, beta, c, n);
+  }
+}
+
+static void gemm_small(int m, int n, int k, double alpha, const double *a,
+                       int rsa, int csa, const double *b, int rsb, int csb,
+                       double beta, double *c, int ldc) {
+  for (int i = 0; i < m; i++) {
+    gemm_scale_row(c + (size_t)i * ldc, n, beta);
+    for (int p = 0; p < k; p++) {
+      double a_ip = alpha * a[(size_t)i * rsa + (size_t)p * csa];
+      for (int j = 0; j < n; j++) {
+        c[(size_t)i * ldc + j] += a_ip * b[(size_t)p * rsb + (size_t)j * csb];
+      }
+    }
+  }
+}
+
+static char gemm_packed(int m, int n, int k, double alpha, const double *a,
+                        int rsa, int csa, const double *b, int rsb, int csb,
+                        double beta, double *c, int ldc) {
+  gemm_kernel_t kernel = gemm_kernel;
+  matrix_arena_mark_t mark = arena_mark(matrix_scratch());
+  double *pack_a = NULL, *pack_b = NULL;
+  char state = 0;
+
+  pack_a = (double *)arena_alloc(matrix_scratch(),
+                                 sizeof(double) * GEMM_MC * GEMM_KC);
+  pack_b = (double *)arena_alloc(matrix_scratch(),
+                                 sizeof(double) * GEMM_KC * GEMM_NC);
+  state = pack_a && pack_b;
+  for (int jc = 0; state && jc < n; jc += GEMM_NC) {
+    int nc = n - jc < GEMM_NC ? n - jc : GEMM_NC;
+    for (int pc = 0; pc < k; pc += GEMM_KC) {
+      int kc = k - pc < GEMM_KC ? k - pc : GEMM_KC;
+      gemm_pack_b(kc, nc, b + (size_t)pc * rsb + (size_t)jc * csb, rsb, csb,
+                  pack_b);
+      for (int ic = 0; ic < m; ic += GEMM_MC) {
+        int mc = m - ic < GEMM_MC ? m - ic : GEMM_MC;
+        gemm_pack_a(mc, kc, alpha, a + (size_t)ic * rsa + (size_t)pc * csa,
+                    rsa, csa, pack_a);
+        for (int jr = 0; jr < nc; jr += GEMM_NR) {
+          int nr = nc - jr < GEMM_NR ? nc - jr : GEMM_NR;
+          for (int ir = 0; ir < mc; ir += GEMM_MR) {
+            int mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+            // beta applies once, on the first pass over k
+            kernel(kc, pack_a + (size_t)ir * kc, pack_b + (size_t)jr * kc,
+                   pc ? 1.0 : beta, c + (size_t)(ic + ir) * ldc + jc + jr,
+                   ldc, mr, nr);
+          }
+        }
+      }
+    }
+  }
+  arena_reset(matrix_scratch(), mark);
+
+  return state;
+}
+
+char gemm_serial(int m, int n, int k, double alpha, const double *a, int rsa,
+                 int csa, const double *b, int rsb, int csb, double beta,
+                 double *c, int ldc) {
+  char state = 1;
+
+  if ((double)m * n * k < GEMM_SMALL_VOLUME || alpha == 0.0) {
+    gemm_small(m, n, alpha == 0.0 ? 0 : k, alpha, a, rsa, csa, b, rsb, csb,
+               beta, c, ldc);
+  } else {
+    state = gemm_packed(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+  }
+
+  return state;
+}
+
+// each stripe packs its own panels in the scratch arena of its thread
+static void gemm_stripe_task(void *arg, int begin, int end) {
+  gemm_job_t *job = (gemm_job_t *)arg;
+
+  for (int part = begin; part < end; part++) {
+    int first = part * job->step;
+    char state = 0;
+    if (job->split_rows) {
+      int rows = job->m - first < job->step ? job->m - first : job->step;
+      state = gemm_packed(rows, job->n, job->k, job->alpha,
+                          job->a + (size_t)first * job->rsa, job->rsa, job->csa,
+                          job->b, job->rsb, job->csb, job->beta,
+                          job->c + (size_t)first * job->ldc, job->ldc);
+    } else {
+      int columns = job->n - first < job->step ? job->n - first : job->step;
+      state = gemm_packed(job->m, columns, job->k, job->alpha, job->a,
+                          job->rsa, job->csa, job->b + (size_t)first * job->csb,
+                          job->rsb, job->csb, job->beta, job->c + first,
+                          job->ldc);
+    }
+    if (!state) atomic_store(&job->failed, 1);
+  }
+}
+
+char gemm_blocked(int m, int n, int k, double alpha, const double *a, int rsa,
+                  int csa, const double *b, int rsb, int csb, double beta,
+                  double *c, int ldc) {
+  char state = 1;
+  int threads = get_matrix_threads();
+
+  if (threads < 2 || alpha == 0.0 ||
+      (double)m * n * k < GEMM_PARALLEL_VOLUME) {
+    state = gemm_serial(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, ldc);
+  } else {
+    // one stripe per thread along the longer side of C, in whole tiles
+    int side = m >= n ? m : n, tile = m >= n ? GEMM_MR : GEMM_NR;
+    int step = ((side + threads - 1) / threads + tile - 1) / tile * tile;
+    gemm_job_t job = {m,   n,    k, alpha, a,    rsa,    csa, b,
+                      rsb, csb, beta, c, ldc,  step, m >= n, 0};
+    parallel_for((side + step - 1) / step, 1, gemm_stripe_task, &job);
+    state = !atomic_load(&job.failed);
+  }
+
+  return state;
+}
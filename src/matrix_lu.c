@@ -0,0 +1,399 @@
+#include <stdatomic.h>
+
+#include "matrix.h"
+
+// panel width of blocked LU and column block of its trailing update tasks
+#define LU_BLOCK 64
+// multiply-adds one substitution task handles at least
+#define LU_SUBSTITUTE_VOLUME 65536
+
+// trailing update after panel of "width" columns starting at "panel"
+typedef struct lu_update_job_struct {
+  double *a;
+  int n;
+  int lda;
+  int panel;
+  int width;
+  atomic_int failed;
+} lu_update_job_t;
+
+// right-hand side columns of substitution split between tasks
+typedef struct lu_substitute_job_struct {
+  const double *lu;
+  int n;
+  double *x;
+  int ldx;
+} lu_substitute_job_t;
+
+// columns [begin, end) of trailing matrix: U12 = L11^-1 * A12, then
+// A22 -= L21 * U12
+static void lu_update_task(void *arg, int begin, int end) {
+  lu_update_job_t *job = (lu_update_job_t *)arg;
+  int lda = job->lda, first = job->panel + job->width;
+  double *l11 = job->a + (size_t)job->panel * lda + job->panel;
+  double *a12 = l11 + job->width + begin;
+
+  for (int i = 1; i < job->width; i++) {
+    for (int p = 0; p < i; p++) {
+      matrix_kernels.axpy(-l11[(size_t)i * lda + p], a12 + (size_t)p * lda,
+                          a12 + (size_t)i * lda, end - begin);
+    }
+  }
+  if (first < job->n &&
+      !gemm_blocked(job->n - first, end - begin, job->width, -1.0,
+                    l11 + (size_t)job->width * lda, lda, 1, a12, lda, 1, 1.0,
+                    a12 + (size_t)job->width * lda, lda)) {
+    atomic_store(&job->failed, 1);
+  }
+}
+
+static void lu_substitute_task(void *arg, int begin, int end) {
+  const lu_substitute_job_t *job = (const lu_substitute_job_t *)arg;
+
+  lu_substitute(job->lu, job->n, job->n, job->x + begin, end - begin,
+                job->ldx);
+}
+
+lu_t lu_decompose(matrix_t *a) {
+  lu_t lu;
+  char state = 0;
+
+  lu_error(&lu);
+  state = base_check_matrices(a, NULL);
+  if (a && state && a->rows == a->columns) {
+    lu.lu = allocate_matrix(get_matrix_arena(), a->rows, a->columns);
+    lu.pivots = (int *)matrix_alloc(sizeof(int) * a->rows);
+    state = lu.lu.matrix && lu.pivots;
+    if (state) {
+      copy_matrix(*a, &lu.lu);
+      state = lu_factor_blocked(lu.lu.data, lu.lu.rows, lu.lu.stride,
+                                lu.pivots, &lu.sign);
+      lu.lu.matrix_type = CORRECT_MATRIX;
+    }
+    if (!state) remove_lu(&lu);
+  }
+
+  return lu;
+}
+
+void remove_lu(lu_t *lu) {
+  if (lu) {
+    remove_matrix(&lu->lu);
+    matrix_free(lu->pivots);
+    lu_error(lu);
+  }
+}
+
+double lu_determinant(lu_t *lu) {
+  double returnable = NAN;
+
+  if (lu && lu->pivots && lu->lu.matrix) {
+    returnable = lu->sign * multiply_diagonal(lu->lu);
+  }
+
+  return returnable;
+}
+
+matrix_t lu_solve(lu_t *lu, matrix_t *b) {
+  matrix_t matrix;
+  char state = 0;
+
+  state = base_check_matrices(b, NULL);
+  if (b && state && lu && lu->pivots && lu->lu.rows == b->rows &&
+      fabs(lu_determinant(lu)) >= ACCURACY) {
+    matrix = allocate_matrix(get_matrix_arena(), b->rows, b->columns);
+    if (matrix.matrix) {
+      for (int i = 0; i < b->rows; i++) {
+        memcpy(matrix.matrix[i], b->matrix[lu->pivots[i]],
+               sizeof(double) * b->columns);
+      }
+      lu_substitute(lu->lu.data, lu->lu.rows, lu->lu.stride, matrix.data,
+                    matrix.columns, matrix.stride);
+      matrix.matrix_type = UNKNOWN_MATRIX;
+    }
+  } else {
+    matrix_error(&matrix);
+  }
+
+  return matrix;
+}
+
+matrix_t solve_matrix(matrix_t *a, matrix_t *b) {
+  matrix_t matrix;
+  lu_t lu;
+
+  lu = lu_decompose(a);
+  matrix = lu_solve(&lu, b);
+  remove_lu(&lu);
+
+  return matrix;
+}
+
+char calculate_LU_inverse(matrix_t a, matrix_t *res) {
+  int n = a.rows, sign = 1, *pivots = NULL;
+  size_t data_size = matrix_data_size(n, n);
+  double det = 0.0, *scratch = NULL;
+  matrix_arena_mark_t mark = arena_mark(matrix_scratch());
+  char state = 0;
+
+  scratch = (double *)arena_alloc(matrix_scratch(),
+                                  data_size + matrix_rows_size(n));
+  if (scratch) {
+    pivots = (int *)((char *)scratch + data_size);
+    copy_to_scratch(a, scratch);
+    state = lu_factor_blocked(scratch, n, n, pivots, &sign);
+    det = lu_diagonal_product(scratch, n, n, sign);
+    state = state && fabs(det) >= ACCURACY;
+  }
+  if (state) {
+    // P * I: row i holds single 1 in column pivots[i]
+    for (int i = 0; i < n; i++) {
+      memset(res->matrix[i], 0, sizeof(double) * n);
+      res->matrix[i][pivots[i]] = 1.0;
+    }
+    lu_substitute_columns(scratch, n, res->data, res->stride);
+    set_result_type(res, has_type(a, IDENTITY_MATRIX) ? IDENTITY_MATRIX
+                                                      : UNKNOWN_MATRIX);
+  }
+  arena_reset(matrix_scratch(), mark);
+
+  return state;
+}
+
+char calculate_LU_complements(matrix_t a, matrix_t *res) {
+  int n = a.rows, sign = 1, *rows = NULL, *cols = NULL;
+  size_t data_size = matrix_data_size(n, n);
+  double det = 0.0, *scratch = NULL, *x = NULL, *y = NULL;
+  matrix_arena_mark_t mark = arena_mark(matrix_scratch());
+  char state = 0;
+
+  // elements, two work vectors and two permutations in one block
+  scratch = (double *)arena_alloc(matrix_scratch(),
+                                  data_size + 3 * matrix_rows_size(n));
+  if (scratch) {
+    x = (double *)((char *)scratch + data_size);
+    y = x + n;
+    rows = (int *)(y + n);
+    cols = rows + n;
+    copy_to_scratch(a, scratch);
+    state = lu_factor_blocked(scratch, n, n, rows, &sign);
+  }
+  if (state) {
+    det = lu_diagonal_product(scratch, n, n, sign);
+    // same criterion as calculate_LU_inverse()
+    if (fabs(det) >= ACCURACY) {
+      // cofactor matrix of nonsingular A is det(A) * A^-T; columns of A^-1
+      // are independent solves, so they are split between threads
+      for (int i = 0; i < n; i++) {
+        memset(res->matrix[i], 0, sizeof(double) * n);
+        res->matrix[i][rows[i]] = 1.0;
+      }
+      lu_substitute_columns(scratch, n, res->data, res->stride);
+      transpose_and_scale(res->data, n, res->stride, det);
+    } else {
+      copy_to_scratch(a, scratch);
+      lu_factor_complete(scratch, n, n, rows, cols, &sign);
+      adjugate_transposed_of_complete_lu(scratch, n, rows, cols, sign, x, y,
+                                         res);
+    }
+  }
+  arena_reset(matrix_scratch(), mark);
+
+  return state;
+}
+
+void adjugate_transposed_of_complete_lu(const double *lu, int n,
+                                        const int *rows, const int *cols,
+                                        int sign, double *x, double *y,
+                                        matrix_t *res) {
+  double scale = sign;
+  int rank = 0;
+
+  // complete pivoting leaves exact zero pivots only after the last nonzero
+  // one; rounding residue is no zero and goes through det(A) * A^-T, which
+  // stays accurate since the tiny pivot cancels between det and U^-1
+  while (rank < n && lu[(size_t)rank * n + rank] != 0.0) rank++;
+  for (int k = 0; k < rank; k++) scale *= lu[(size_t)k * n + k];
+  for (int i = 0; i < n; i++) memset(res->matrix[i], 0, sizeof(double) * n);
+  if (rank == n) {
+    // A^-1 = Q * U^-1 * L^-1 * P, so columns of A^-T move by "cols"
+    for (int i = 0; i < n; i++) res->matrix[i][rows[i]] = 1.0;
+    lu_substitute_columns(lu, n, res->data, res->stride);
+    transpose_and_scale(res->data, n, res->stride, scale);
+    for (int i = 0; i < n; i++) {
+      memcpy(x, res->matrix[i], sizeof(double) * n);
+      for (int j = 0; j < n; j++) res->matrix[i][cols[j]] = x[j];
+    }
+  } else if (rank == n - 1) {
+    // P * A * Q = L * U with zero last pivot: adj(U) = d * x * e^T, where
+    // U * x = 0, and e^T * L^-1 = y^T, so cofactors are d * y * x^T permuted
+    x[n - 1] = 1.0;
+    for (int i = n - 2; i >= 0; i--) {
+      double sum = 0.0;
+      for (int k = i + 1; k < n; k++) sum += lu[(size_t)i * n + k] * x[k];
+      x[i] = -sum / lu[(size_t)i * n + i];
+    }
+    y[n - 1] = 1.0;
+    for (int k = n - 2; k >= 0; k--) {
+      double sum = 0.0;
+      for (int i = k + 1; i < n; i++) sum += y[i] * lu[(size_t)i * n + k];
+      y[k] = -sum;
+    }
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        res->matrix[rows[i]][cols[j]] = scale * y[i] * x[j];
+      }
+    }
+  }
+}
+
+void lu_factor_complete(double *a, int n, int lda, int *rows, int *cols,
+                        int *sign) {
+  *sign = 1;
+  for (int i = 0; i < n; i++) rows[i] = cols[i] = i;
+  for (int k = 0; k < n; k++) {
+    int pivot_row = k, pivot_col = k;
+    for (int i = k; i < n; i++) {
+      for (int j = k; j < n; j++) {
+        if (fabs(a[(size_t)i * lda + j]) >
+            fabs(a[(size_t)pivot_row * lda + pivot_col])) {
+          pivot_row = i;
+          pivot_col = j;
+        }
+      }
+    }
+    if (pivot_row != k) {
+      int buffer = rows[k];
+      rows[k] = rows[pivot_row];
+      rows[pivot_row] = buffer;
+      swap_rows(a + (size_t)k * lda, a + (size_t)pivot_row * lda, n);
+      *sign = -*sign;
+    }
+    if (pivot_col != k) {
+      int buffer = cols[k];
+      cols[k] = cols[pivot_col];
+      cols[pivot_col] = buffer;
+      for (int i = 0; i < n; i++) {
+        double value = a[(size_t)i * lda + k];
+        a[(size_t)i * lda + k] = a[(size_t)i * lda + pivot_col];
+        a[(size_t)i * lda + pivot_col] = value;
+      }
+      *sign = -*sign;
+    }
+    double *row_k = a + (size_t)k * lda;
+    if (row_k[k] != 0.0) {
+      for (int i = k + 1; i < n; i++) {
+        double *row_i = a + (size_t)i * lda;
+        double multiplier = row_i[k] / row_k[k];
+        row_i[k] = multiplier;
+        for (int j = k + 1; j < n; j++) row_i[j] -= multiplier * row_k[j];
+      }
+    }
+  }
+}
+
+double lu_diagonal_product(const double *lu, int n, int ldlu, int sign) {
+  double returnable = sign;
+
+  for (int i = 0; i < n; i++) returnable *= lu[(size_t)i * ldlu + i];
+
+  return returnable;
+}
+
+void copy_to_scratch(matrix_t a, double *scratch) {
+  for (int i = 0; i < a.rows; i++) {
+    memcpy(scratch + (size_t)i * a.columns, a.matrix[i],
+           sizeof(double) * a.columns);
+  }
+}
+
+void transpose_and_scale(double *a, int n, int lda, double number) {
+  transpose_square(a, n, lda);
+  for (int i = 0; i < n; i++) {
+    matrix_kernels.scale(a + (size_t)i * lda, number, a + (size_t)i * lda, n);
+  }
+}
+
+char lu_factor_blocked(double *a, int n, int lda, int *pivots, int *sign) {
+  char state = 1;
+
+  *sign = 1;
+  for (int i = 0; i < n; i++) pivots[i] = i;
+  for (int panel = 0; state && panel < n; panel += LU_BLOCK) {
+    int width = n - panel < LU_BLOCK ? n - panel : LU_BLOCK;
+    // panel columns only; whole rows are swapped, so no swaps are deferred
+    for (int k = panel; k < panel + width; k++) {
+      double *row_k = a + (size_t)k * lda;
+      int pivot = k;
+      for (int i = k + 1; i < n; i++) {
+        if (fabs(a[(size_t)i * lda + k]) > fabs(a[(size_t)pivot * lda + k])) {
+          pivot = i;
+        }
+      }
+      if (pivot != k) {
+        int buffer = pivots[k];
+        pivots[k] = pivots[pivot];
+        pivots[pivot] = buffer;
+        swap_rows(row_k, a + (size_t)pivot * lda, n);
+        *sign = -*sign;
+      }
+      for (int i = k + 1; row_k[k] != 0.0 && i < n; i++) {
+        double *row_i = a + (size_t)i * lda;
+        double multiplier = row_i[k] / row_k[k];
+        row_i[k] = multiplier;
+        matrix_kernels.axpy(-multiplier, row_k + k + 1, row_i + k + 1,
+                            panel + width - k - 1);
+      }
+    }
+    if (panel + width < n) {
+      lu_update_job_t job = {a, n, lda, panel, width, 0};
+      parallel_for(n - panel - width, LU_BLOCK, lu_update_task, &job);
+      state = !atomic_load(&job.failed);
+    }
+  }
+
+  return state;
+}
+
+void lu_substitute_columns(const double *lu, int n, double *x, int ldx) {
+  lu_substitute_job_t job = {lu, n, x, ldx};
+  int grain = LU_SUBSTITUTE_VOLUME / n / n + 1;
+
+  // whole cache lines of every row of "x" per task
+  grain = (grain + 7) / 8 * 8;
+  parallel_for(n, grain, lu_substitute_task, &job);
+}
+
+void lu_substitute(const double *lu, int n, int ldlu, double *x, int nrhs,
+                   int ldx) {
+  for (int i = 1; i < n; i++) {
+    double *row_i = x + (size_t)i * ldx;
+    for (int k = 0; k < i; k++) {
+      double l_ik = lu[(size_t)i * ldlu + k];
+      matrix_kernels.axpy(-l_ik, x + (size_t)k * ldx, row_i, nrhs);
+    }
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    double *row_i = x + (size_t)i * ldx;
+    for (int k = i + 1; k < n; k++) {
+      double u_ik = lu[(size_t)i * ldlu + k];
+      matrix_kernels.axpy(-u_ik, x + (size_t)k * ldx, row_i, nrhs);
+    }
+    double inverse_pivot = 1.0 / lu[(size_t)i * ldlu + i];
+    matrix_kernels.scale(row_i, inverse_pivot, row_i, nrhs);
+  }
+}
+
+void swap_rows(double *a, double *b, int n) {
+  for (int j = 0; j < n; j++) {
+    double buffer = a[j];
+    a[j] = b[j];
+    b[j] = buffer;
+  }
+}
+
+void lu_error(lu_t *lu) {
+  matrix_error(&lu->lu);
+  lu->pivots = NULL;
+  lu->sign = 0;
+}
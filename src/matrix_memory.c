@@ -0,0 +1,118 @@
+#include <stdatomic.h>
+
+#include "matrix.h"
+
+// library-wide heap traffic counters
+static atomic_size_t allocations_count = 0;
+static atomic_size_t allocated_bytes = 0;
+static atomic_size_t frees_count = 0;
+
+// freed matrix buffers of one size, chained through their first bytes
+#define CACHE_BINS 32
+
+typedef struct cache_bin_struct {
+  size_t size;
+  size_t count;
+  void *head;
+} cache_bin_t;
+
+// opt-in buffer cache of the calling thread, see set_matrix_cache_limit()
+static _Thread_local cache_bin_t cache_bins[CACHE_BINS];
+static _Thread_local matrix_cache_stats_t cache_stats;
+static _Thread_local size_t cache_limit = 0;
+
+void *matrix_alloc(size_t size) {
+  void *returnable = NULL;
+
+  size = (size + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+  returnable = aligned_alloc(MATRIX_ALIGNMENT, size ? size : MATRIX_ALIGNMENT);
+  if (returnable) {
+    atomic_fetch_add_explicit(&allocations_count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&allocated_bytes, size, memory_order_relaxed);
+  }
+
+  return returnable;
+}
+
+void matrix_free(void *ptr) {
+  if (ptr) {
+    atomic_fetch_add_explicit(&frees_count, 1, memory_order_relaxed);
+    free(ptr);
+  }
+}
+
+matrix_alloc_stats_t get_matrix_alloc_stats(void) {
+  matrix_alloc_stats_t stats;
+
+  stats.allocations =
+      atomic_load_explicit(&allocations_count, memory_order_relaxed);
+  stats.bytes = atomic_load_explicit(&allocated_bytes, memory_order_relaxed);
+  stats.frees = atomic_load_explicit(&frees_count, memory_order_relaxed);
+
+  return stats;
+}
+
+void *matrix_buffer_take(size_t size) {
+  void *returnable = NULL;
+
+  for (int i = 0; cache_limit && !returnable && i < CACHE_BINS; i++) {
+    cache_bin_t *bin = cache_bins + i;
+    if (bin->count && bin->size == size) {
+      returnable = bin->head;
+      bin->head = *(void **)returnable;
+      bin->count--;
+      cache_stats.buffers--;
+      cache_stats.bytes -= size;
+    }
+  }
+  if (returnable) {
+    cache_stats.hits++;
+  } else {
+    if (cache_limit) cache_stats.misses++;
+    returnable = matrix_alloc(size);
+  }
+
+  return returnable;
+}
+
+void matrix_buffer_give(void *ptr, size_t size) {
+  cache_bin_t *bin = NULL;
+
+  if (ptr && cache_limit && cache_stats.bytes + size <= cache_limit) {
+    // bin of this size, otherwise the first empty one
+    for (int i = 0; i < CACHE_BINS && (!bin || bin->size != size); i++) {
+      if (cache_bins[i].size == size || (!bin && !cache_bins[i].count)) {
+        bin = cache_bins + i;
+      }
+    }
+  }
+  if (bin) {
+    if (!bin->count) bin->size = size;
+    *(void **)ptr = bin->head;
+    bin->head = ptr;
+    bin->count++;
+    cache_stats.buffers++;
+    cache_stats.bytes += size;
+  } else {
+    matrix_free(ptr);
+  }
+}
+
+void set_matrix_cache_limit(size_t bytes) {
+  cache_limit = bytes;
+  for (int i = 0; cache_stats.bytes > cache_limit && i < CACHE_BINS; i++) {
+    cache_bin_t *bin = cache_bins + i;
+    while (bin->count && cache_stats.bytes > cache_limit) {
+      void *buffer = bin->head;
+      bin->head = *(void **)buffer;
+      bin->count--;
+      cache_stats.buffers--;
+      cache_stats.bytes -= bin->size;
+      matrix_free(buffer);
+    }
+  }
+}
+
+size_t get_matrix_cache_limit(void) { return cache_limit; }
+
+matrix_cache_stats_t get_matrix_cache_stats(void) { return cache_stats; }
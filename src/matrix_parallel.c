@@ -0,0 +1,89 @@
+#include <stdatomic.h>
+
+#include "matrix.h"
+
+// product blocks up to this size in both dimensions are not split further
+#define PRODUCT_TILE 256
+// split points of product columns keep whole cache lines in one task
+#define PRODUCT_ALIGN 8
+
+// block of C = A * B; halves share "failed" flag of the whole product
+typedef struct product_block_struct {
+  int m;
+  int n;
+  int k;
+  const double *a;
+  int lda;
+  const double *b;
+  int ldb;
+  double *c;
+  int ldc;
+  atomic_int *failed;
+} product_block_t;
+
+static void multiply_block(product_block_t block);
+
+static void product_halves_task(void *arg, int begin, int end) {
+  product_block_t *halves = (product_block_t *)arg;
+
+  for (int i = begin; i < end; i++) multiply_block(halves[i]);
+}
+
+static void multiply_block(product_block_t block) {
+  if (block.m <= PRODUCT_TILE && block.n <= PRODUCT_TILE) {
+    if (!gemm_serial(block.m, block.n, block.k, 1.0, block.a, block.lda, 1,
+                     block.b, block.ldb, 1, 0.0, block.c, block.ldc)) {
+      atomic_store(block.failed, 1);
+    }
+  } else {
+    product_block_t halves[2] = {block, block};
+    if (block.m >= block.n) {
+      int half = block.m / 2;
+      halves[0].m = half;
+      halves[1].m = block.m - half;
+      halves[1].a += (size_t)half * block.lda;
+      halves[1].c += (size_t)half * block.ldc;
+    } else {
+      int half = (block.n / 2 + PRODUCT_ALIGN - 1) / PRODUCT_ALIGN *
+                 PRODUCT_ALIGN;
+      halves[0].n = half;
+      halves[1].n = block.n - half;
+      halves[1].b += half;
+      halves[1].c += half;
+    }
+    parallel_for(2, 1, product_halves_task, halves);
+  }
+}
+
+// determinant() and inverse_matrix() run on the same blocked LU task tree
+double matrix_parallel_determinant(matrix_t *a) { return determinant(a); }
+
+matrix_t matrix_parallel_inverse(matrix_t *a) { return inverse_matrix(a); }
+
+matrix_t matrix_parallel_mult(matrix_t *a, matrix_t *b) {
+  matrix_t matrix;
+  atomic_int failed = 0;
+  char state = 0;
+
+  state = base_check_matrices(a, b);
+  if (a && b && state && a->columns == b->rows) {
+    matrix = allocate_matrix(get_matrix_arena(), a->rows, b->columns);
+    if (matrix.matrix) {
+      multiply_block((product_block_t){a->rows, b->columns, a->columns,
+                                       a->data, a->stride, b->data, b->stride,
+                                       matrix.data, matrix.stride, &failed});
+      set_result_type(&matrix, has_type(*a, IDENTITY_MATRIX) &&
+                                       has_type(*b, IDENTITY_MATRIX)
+                                   ? IDENTITY_MATRIX
+                                   : UNKNOWN_MATRIX);
+    }
+    if (!matrix.matrix || atomic_load(&failed)) {
+      remove_matrix(&matrix);
+      matrix_error(&matrix);
+    }
+  } else {
+    matrix_error(&matrix);
+  }
+
+  return matrix;
+}
@@ -0,0 +1,245 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#include "matrix.h"
+
+// most workers the pool starts regardless of requested count
+#define POOL_MAX_THREADS 256
+// spawned and unfinished tasks one thread may hold, more run inline
+#define POOL_DEQUE_SIZE 256
+
+// range of loop iterations; lives in frame of thread that spawned it
+typedef struct pool_task_struct {
+  matrix_task_t task;
+  void *arg;
+  int begin;
+  int end;
+  int grain;
+  atomic_int done;
+} pool_task_t;
+
+// Chase-Lev deque: owner pushes and pops at bottom, thieves take from top
+typedef struct pool_deque_struct {
+  _Alignas(64) atomic_long top;
+  _Alignas(64) atomic_long bottom;
+  _Atomic(pool_task_t *) tasks[POOL_DEQUE_SIZE];
+} pool_deque_t;
+
+// persistent workers stealing while a loop runs and sleeping between loops
+static struct {
+  pthread_mutex_t lock;
+  pthread_mutex_t submit;  // held by the thread whose loop runs now
+  pthread_cond_t work;
+  pthread_t workers[POOL_MAX_THREADS];
+  atomic_int started;  // workers running
+  atomic_int threads;  // requested count including caller, 0 for all cores
+  int shutdown;        // workers exit when set
+  int busy;            // loop is running, workers look for tasks to steal
+  // slot 0 belongs to thread holding "submit", slot i to worker i
+  pool_deque_t deques[POOL_MAX_THREADS];
+} pool = {.lock = PTHREAD_MUTEX_INITIALIZER,
+          .submit = PTHREAD_MUTEX_INITIALIZER,
+          .work = PTHREAD_COND_INITIALIZER};
+
+// deque of the calling thread, -1 outside of the pool
+static _Thread_local int pool_slot = -1;
+static _Thread_local unsigned pool_seed = 0;
+
+static int pool_push(pool_deque_t *deque, pool_task_t *task) {
+  long bottom = atomic_load(&deque->bottom), top = atomic_load(&deque->top);
+  int state = bottom - top < POOL_DEQUE_SIZE;
+
+  if (state) {
+    atomic_store(&deque->tasks[bottom % POOL_DEQUE_SIZE], task);
+    atomic_store(&deque->bottom, bottom + 1);
+  }
+
+  return state;
+}
+
+static pool_task_t *pool_pop(pool_deque_t *deque) {
+  long bottom = atomic_load(&deque->bottom) - 1, top = 0;
+  pool_task_t *task = NULL;
+
+  atomic_store(&deque->bottom, bottom);
+  top = atomic_load(&deque->top);
+  if (top <= bottom) {
+    task = atomic_load(&deque->tasks[bottom % POOL_DEQUE_SIZE]);
+    // last task may be taken by a thief at the same time
+    if (top == bottom) {
+      if (!atomic_compare_exchange_strong(&deque->top, &top, top + 1)) {
+        task = NULL;
+      }
+      atomic_store(&deque->bottom, bottom + 1);
+    }
+  } else {
+    atomic_store(&deque->bottom, bottom + 1);
+  }
+
+  return task;
+}
+
+static pool_task_t *pool_steal(pool_deque_t *deque) {
+  long top = atomic_load(&deque->top), bottom = atomic_load(&deque->bottom);
+  pool_task_t *task = NULL;
+
+  if (top < bottom) {
+    task = atomic_load(&deque->tasks[top % POOL_DEQUE_SIZE]);
+    if (!atomic_compare_exchange_strong(&deque->top, &top, top + 1)) {
+      task = NULL;
+    }
+  }
+
+  return task;
+}
+
+// visits deques starting from a random victim, so thieves spread out
+static pool_task_t *pool_steal_any(void) {
+  int slots = atomic_load(&pool.started) + 1, victim = 0;
+  pool_task_t *task = NULL;
+
+  pool_seed = pool_seed * 1103515245u + 12345u;
+  victim = (int)((pool_seed >> 16) % (unsigned)slots);
+  for (int i = 0; !task && i < slots; i++, victim = (victim + 1) % slots) {
+    if (victim != pool_slot) task = pool_steal(pool.deques + victim);
+  }
+
+  return task;
+}
+
+static void pool_split(matrix_task_t task, void *arg, int begin, int end,
+                       int grain);
+
+static void pool_run(pool_task_t *task) {
+  pool_split(task->task, task->arg, task->begin, task->end, task->grain);
+  atomic_store(&task->done, 1);
+}
+
+// left half runs here while right half waits to be stolen; chunk borders
+// stay at multiples of "grain" from the loop start
+static void pool_split(matrix_task_t task, void *arg, int begin, int end,
+                       int grain) {
+  pool_deque_t *deque = pool.deques + pool_slot;
+  char waiting = 0;
+
+  while (!waiting && end - begin > grain) {
+    int middle = begin + ((end - begin - 1) / grain + 1) / 2 * grain;
+    pool_task_t right = {task, arg, middle, end, grain, 0};
+    if (!pool_push(deque, &right)) {
+      pool_split(task, arg, middle, end, grain);
+      end = middle;
+    } else {
+      pool_split(task, arg, begin, middle, grain);
+      if (pool_pop(deque) == &right) {
+        begin = middle;
+      } else {
+        // right half was stolen: run other tasks until the thief is done
+        while (!atomic_load(&right.done)) {
+          pool_task_t *other = pool_steal_any();
+          if (other) {
+            pool_run(other);
+          } else {
+            sched_yield();
+          }
+        }
+        waiting = 1;
+      }
+    }
+  }
+  if (!waiting) task(arg, begin, end);
+}
+
+static void *pool_worker(void *slot) {
+  pool_slot = (int)(size_t)slot;
+  pool_seed = (unsigned)pool_slot;
+  pthread_mutex_lock(&pool.lock);
+  while (!pool.shutdown) {
+    if (pool.busy) {
+      pthread_mutex_unlock(&pool.lock);
+      pool_task_t *task = pool_steal_any();
+      if (task) {
+        pool_run(task);
+      } else {
+        sched_yield();
+      }
+      pthread_mutex_lock(&pool.lock);
+    } else {
+      pthread_cond_wait(&pool.work, &pool.lock);
+    }
+  }
+  pthread_mutex_unlock(&pool.lock);
+  release_matrix_scratch();
+
+  return NULL;
+}
+
+static void pool_start(void) {
+  int wanted = get_matrix_threads() - 1, started = atomic_load(&pool.started);
+
+  // workers are created lazily by the first parallel loop
+  while (started < wanted &&
+         !pthread_create(pool.workers + started, NULL, pool_worker,
+                         (void *)(size_t)(started + 1))) {
+    atomic_store(&pool.started, ++started);
+  }
+}
+
+static void pool_stop(void) {
+  pthread_mutex_lock(&pool.lock);
+  pool.shutdown = 1;
+  pthread_cond_broadcast(&pool.work);
+  pthread_mutex_unlock(&pool.lock);
+  for (int i = 0; i < atomic_load(&pool.started); i++) {
+    pthread_join(pool.workers[i], NULL);
+  }
+  atomic_store(&pool.started, 0);
+  pool.shutdown = 0;
+}
+
+void set_matrix_threads(int count) {
+  pthread_mutex_lock(&pool.submit);
+  pool_stop();
+  atomic_store(&pool.threads, count > 0 ? count : 0);
+  pthread_mutex_unlock(&pool.submit);
+}
+
+int get_matrix_threads(void) {
+  int returnable = atomic_load(&pool.threads);
+
+  if (!returnable) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    returnable = cores > 0 ? (int)cores : 1;
+  }
+
+  return returnable < POOL_MAX_THREADS ? returnable : POOL_MAX_THREADS;
+}
+
+void parallel_for(int count, int grain, matrix_task_t task, void *arg) {
+  if (grain < 1) grain = 1;
+  if (count <= grain || get_matrix_threads() < 2) {
+    if (count > 0) task(arg, 0, count);
+  } else if (pool_slot >= 0) {
+    // loops nested in tasks spawn into the deque of their thread
+    pool_split(task, arg, 0, count, grain);
+  } else if (pthread_mutex_trylock(&pool.submit)) {
+    // pool runs a loop of another thread
+    task(arg, 0, count);
+  } else {
+    pool_start();
+    pool_slot = 0;
+    pthread_mutex_lock(&pool.lock);
+    pool.busy = 1;
+    pthread_cond_broadcast(&pool.work);
+    pthread_mutex_unlock(&pool.lock);
+
+    pool_split(task, arg, 0, count, grain);
+
+    pthread_mutex_lock(&pool.lock);
+    pool.busy = 0;
+    pthread_mutex_unlock(&pool.lock);
+    pool_slot = -1;
+    pthread_mutex_unlock(&pool.submit);
+  }
+}
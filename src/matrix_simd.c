@@ -0,0 +1,195 @@
+#include "matrix.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIMD_X86 1
+#endif
+
+static void add_scalar(const double *a, const double *b, double *res,
+                       size_t n) {
+  for (size_t i = 0; i < n; i++) res[i] = a[i] + b[i];
+}
+
+static void sub_scalar(const double *a, const double *b, double *res,
+                       size_t n) {
+  for (size_t i = 0; i < n; i++) res[i] = a[i] - b[i];
+}
+
+static void scale_scalar(const double *a, double number, double *res,
+                         size_t n) {
+  for (size_t i = 0; i < n; i++) res[i] = a[i] * number;
+}
+
+static void axpy_scalar(double alpha, const double *x, double *y, size_t n) {
+  for (size_t i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+static int compare_scalar(const double *a, const double *b, size_t n,
+                          double accuracy) {
+  int equal = 1;
+
+  for (size_t i = 0; equal && i < n; i++) {
+    equal = fabs(a[i] - b[i]) < accuracy;
+  }
+
+  return equal;
+}
+
+#ifdef SIMD_X86
+__attribute__((target("avx2"))) static void add_avx2(const double *a,
+                                                     const double *b,
+                                                     double *res, size_t n) {
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m256d x = _mm256_loadu_pd(a + i), y = _mm256_loadu_pd(b + i);
+    _mm256_storeu_pd(res + i, _mm256_add_pd(x, y));
+  }
+  add_scalar(a + i, b + i, res + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void sub_avx2(const double *a,
+                                                     const double *b,
+                                                     double *res, size_t n) {
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m256d x = _mm256_loadu_pd(a + i), y = _mm256_loadu_pd(b + i);
+    _mm256_storeu_pd(res + i, _mm256_sub_pd(x, y));
+  }
+  sub_scalar(a + i, b + i, res + i, n - i);
+}
+
+__attribute__((target("avx2"))) static void scale_avx2(const double *a,
+                                                       double number,
+                                                       double *res, size_t n) {
+  __m256d k = _mm256_set1_pd(number);
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(res + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), k));
+  }
+  scale_scalar(a + i, number, res + i, n - i);
+}
+
+__attribute__((target("avx2,fma"))) static void axpy_avx2(double alpha,
+                                                          const double *x,
+                                                          double *y, size_t n) {
+  __m256d k = _mm256_set1_pd(alpha);
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m256d xi = _mm256_loadu_pd(x + i), yi = _mm256_loadu_pd(y + i);
+    _mm256_storeu_pd(y + i, _mm256_fmadd_pd(k, xi, yi));
+  }
+  axpy_scalar(alpha, x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2"))) static int compare_avx2(const double *a,
+                                                        const double *b,
+                                                        size_t n,
+                                                        double accuracy) {
+  __m256d limit = _mm256_set1_pd(accuracy), sign = _mm256_set1_pd(-0.0);
+  int equal = 1;
+  size_t i = 0;
+
+  for (; equal && i + 4 <= n; i += 4) {
+    __m256d x = _mm256_loadu_pd(a + i), y = _mm256_loadu_pd(b + i);
+    __m256d diff = _mm256_andnot_pd(sign, _mm256_sub_pd(x, y));
+    __m256d close = _mm256_cmp_pd(diff, limit, _CMP_LT_OQ);
+    equal = _mm256_movemask_pd(close) == 0xF;
+  }
+
+  return equal && compare_scalar(a + i, b + i, n - i, accuracy);
+}
+
+__attribute__((target("avx512f"))) static void add_avx512(const double *a,
+                                                          const double *b,
+                                                          double *res,
+                                                          size_t n) {
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m512d x = _mm512_loadu_pd(a + i), y = _mm512_loadu_pd(b + i);
+    _mm512_storeu_pd(res + i, _mm512_add_pd(x, y));
+  }
+  add_scalar(a + i, b + i, res + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void sub_avx512(const double *a,
+                                                          const double *b,
+                                                          double *res,
+                                                          size_t n) {
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m512d x = _mm512_loadu_pd(a + i), y = _mm512_loadu_pd(b + i);
+    _mm512_storeu_pd(res + i, _mm512_sub_pd(x, y));
+  }
+  sub_scalar(a + i, b + i, res + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void scale_avx512(const double *a,
+                                                            double number,
+                                                            double *res,
+                                                            size_t n) {
+  __m512d k = _mm512_set1_pd(number);
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(res + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), k));
+  }
+  scale_scalar(a + i, number, res + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void axpy_avx512(double alpha,
+                                                           const double *x,
+                                                           double *y,
+                                                           size_t n) {
+  __m512d k = _mm512_set1_pd(alpha);
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m512d xi = _mm512_loadu_pd(x + i), yi = _mm512_loadu_pd(y + i);
+    _mm512_storeu_pd(y + i, _mm512_fmadd_pd(k, xi, yi));
+  }
+  axpy_scalar(alpha, x + i, y + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static int compare_avx512(const double *a,
+                                                             const double *b,
+                                                             size_t n,
+                                                             double accuracy) {
+  __m512d limit = _mm512_set1_pd(accuracy);
+  int equal = 1;
+  size_t i = 0;
+
+  for (; equal && i + 8 <= n; i += 8) {
+    __m512d x = _mm512_loadu_pd(a + i), y = _mm512_loadu_pd(b + i);
+    __m512d diff = _mm512_abs_pd(_mm512_sub_pd(x, y));
+    equal = _mm512_cmp_pd_mask(diff, limit, _CMP_LT_OQ) == 0xFF;
+  }
+
+  return equal && compare_scalar(a + i, b + i, n - i, accuracy);
+}
+#endif
+
+// scalar kernels until simd_select_kernels() runs at load time
+matrix_kernels_t matrix_kernels = {"scalar",     add_scalar,  sub_scalar,
+                                   scale_scalar, axpy_scalar, compare_scalar};
+
+#ifdef SIMD_X86
+__attribute__((constructor)) static void simd_select_kernels(void) {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    matrix_kernels = (matrix_kernels_t){"avx512",     add_avx512,
+                                        sub_avx512,   scale_avx512,
+                                        axpy_avx512,  compare_avx512};
+  } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    matrix_kernels = (matrix_kernels_t){"avx2",     add_avx2,  sub_avx2,
+                                        scale_avx2, axpy_avx2, compare_avx2};
+  }
+}
+#endif
+
+const char *matrix_simd_level(void) { return matrix_kernels.name; }
@@ -0,0 +1,179 @@
+#include <stdatomic.h>
+
+#include "matrix.h"
+
+// products whose smallest size is at most this use blocked GEMM by default
+#define STRASSEN_CUTOFF 1024
+// temporaries are rounded to whole cache lines to keep them aligned
+#define STRASSEN_ALIGN (MATRIX_ALIGNMENT / (int)sizeof(double))
+
+static atomic_int product_algorithm = PRODUCT_CLASSIC;
+static atomic_int strassen_cutoff = STRASSEN_CUTOFF;
+
+static size_t strassen_block(int rows, int columns) {
+  size_t size = (size_t)rows * columns;
+
+  return (size + STRASSEN_ALIGN - 1) / STRASSEN_ALIGN * STRASSEN_ALIGN;
+}
+
+// doubles of temporaries one recursion path holds at once
+static size_t strassen_workspace(int m, int n, int k, int cutoff) {
+  size_t returnable = 0;
+
+  while (m > cutoff && n > cutoff && k > cutoff) {
+    m /= 2;
+    n /= 2;
+    k /= 2;
+    returnable += strassen_block(m, k) + strassen_block(k, n) +
+                  strassen_block(m, n);
+  }
+
+  return returnable;
+}
+
+// c = a + b or c = a - b over blocks of rows split between threads
+typedef struct strassen_job_struct {
+  matrix_binary_kernel_t kernel;
+  int columns;
+  const double *a;
+  int lda;
+  const double *b;
+  int ldb;
+  double *c;
+  int ldc;
+} strassen_job_t;
+
+static void strassen_combine_task(void *arg, int begin, int end) {
+  const strassen_job_t *job = (const strassen_job_t *)arg;
+
+  for (int i = begin; i < end; i++) {
+    job->kernel(job->a + (size_t)i * job->lda, job->b + (size_t)i * job->ldb,
+                job->c + (size_t)i * job->ldc, job->columns);
+  }
+}
+
+static void strassen_combine(matrix_binary_kernel_t kernel, int rows,
+                             int columns, const double *a, int lda,
+                             const double *b, int ldb, double *c, int ldc) {
+  strassen_job_t job = {kernel, columns, a, lda, b, ldb, c, ldc};
+
+  parallel_for(rows, elementwise_grain(columns), strassen_combine_task, &job);
+}
+
+static char strassen_multiply(int m, int n, int k, const double *a, int lda,
+                              const double *b, int ldb, double *c, int ldc,
+                              double *workspace, int cutoff);
+
+// Winograd form: 7 half-size products and 15 additions, quadrants of C hold
+// partial results, so only X (A-sized), Y (B-sized) and M1 are extra
+static char strassen_level(int m, int n, int k, const double *a, int lda,
+                           const double *b, int ldb, double *c, int ldc,
+                           double *workspace, int cutoff) {
+  matrix_binary_kernel_t add = matrix_kernels.add, sub = matrix_kernels.sub;
+  const double *a11 = a, *a12 = a + k, *a21 = a + (size_t)m * lda;
+  const double *a22 = a21 + k, *b11 = b, *b12 = b + n;
+  const double *b21 = b + (size_t)k * ldb, *b22 = b21 + n;
+  double *c11 = c, *c12 = c + n, *c21 = c + (size_t)m * ldc, *c22 = c21 + n;
+  double *x = workspace, *y = x + strassen_block(m, k);
+  double *m1 = y + strassen_block(k, n), *rest = m1 + strassen_block(m, n);
+  char state = 0;
+
+  strassen_combine(add, m, k, a21, lda, a22, lda, x, k);
+  strassen_combine(sub, k, n, b12, ldb, b11, ldb, y, n);
+  state = strassen_multiply(m, n, k, x, k, y, n, c22, ldc, rest, cutoff);
+  strassen_combine(sub, m, k, x, k, a11, lda, x, k);
+  strassen_combine(sub, k, n, b22, ldb, y, n, y, n);
+  state = state && strassen_multiply(m, n, k, x, k, y, n, c12, ldc, rest,
+                                     cutoff);
+  strassen_combine(sub, m, k, a12, lda, x, k, x, k);
+  state = state && strassen_multiply(m, n, k, x, k, b22, ldb, c11, ldc, rest,
+                                     cutoff);
+  state = state && strassen_multiply(m, n, k, a11, lda, b11, ldb, m1, n, rest,
+                                     cutoff);
+  strassen_combine(add, m, n, c12, ldc, m1, n, c12, ldc);
+  strassen_combine(sub, m, k, a11, lda, a21, lda, x, k);
+  strassen_combine(sub, k, n, b22, ldb, b12, ldb, y, n);
+  state = state && strassen_multiply(m, n, k, x, k, y, n, c21, ldc, rest,
+                                     cutoff);
+  strassen_combine(add, m, n, c21, ldc, c12, ldc, c21, ldc);
+  strassen_combine(add, m, n, c12, ldc, c22, ldc, c12, ldc);
+  strassen_combine(add, m, n, c22, ldc, c21, ldc, c22, ldc);
+  strassen_combine(add, m, n, c12, ldc, c11, ldc, c12, ldc);
+  strassen_combine(add, k, n, y, n, b11, ldb, y, n);
+  strassen_combine(sub, k, n, y, n, b21, ldb, y, n);
+  state = state && strassen_multiply(m, n, k, a22, lda, y, n, c11, ldc, rest,
+                                     cutoff);
+  strassen_combine(sub, m, n, c21, ldc, c11, ldc, c21, ldc);
+  state = state && strassen_multiply(m, n, k, a12, lda, b21, ldb, c11, ldc,
+                                     rest, cutoff);
+  strassen_combine(add, m, n, c11, ldc, m1, n, c11, ldc);
+
+  return state;
+}
+
+// odd last row, column or inner index is left out of the recursion and
+// added by thin blocked products
+static char strassen_multiply(int m, int n, int k, const double *a, int lda,
+                              const double *b, int ldb, double *c, int ldc,
+                              double *workspace, int cutoff) {
+  char state = 0;
+
+  if (m <= cutoff || n <= cutoff || k <= cutoff) {
+    state = gemm_blocked(m, n, k, 1.0, a, lda, 1, b, ldb, 1, 0.0, c, ldc);
+  } else {
+    int even_m = m & ~1, even_n = n & ~1, even_k = k & ~1;
+    state = strassen_level(even_m / 2, even_n / 2, even_k / 2, a, lda, b, ldb,
+                           c, ldc, workspace, cutoff);
+    if (state && k != even_k) {
+      state = gemm_blocked(even_m, even_n, 1, 1.0, a + even_k, lda, 1,
+                           b + (size_t)even_k * ldb, ldb, 1, 1.0, c, ldc);
+    }
+    if (state && n != even_n) {
+      state = gemm_blocked(even_m, 1, k, 1.0, a, lda, 1, b + even_n, ldb, 1,
+                           0.0, c + even_n, ldc);
+    }
+    if (state && m != even_m) {
+      state = gemm_blocked(1, n, k, 1.0, a + (size_t)even_m * lda, lda, 1, b,
+                           ldb, 1, 0.0, c + (size_t)even_m * ldc, ldc);
+    }
+  }
+
+  return state;
+}
+
+void set_matrix_product(matrix_product_t algorithm) {
+  atomic_store(&product_algorithm, algorithm);
+}
+
+matrix_product_t get_matrix_product(void) {
+  return (matrix_product_t)atomic_load(&product_algorithm);
+}
+
+void set_strassen_cutoff(int size) {
+  atomic_store(&strassen_cutoff, size > 0 ? size : STRASSEN_CUTOFF);
+}
+
+int get_strassen_cutoff(void) { return atomic_load(&strassen_cutoff); }
+
+char gemm_product(int m, int n, int k, const double *a, int lda,
+                  const double *b, int ldb, double *c, int ldc) {
+  int cutoff = get_strassen_cutoff();
+  size_t workspace = strassen_workspace(m, n, k, cutoff);
+  char state = 0;
+
+  if (get_matrix_product() == PRODUCT_CLASSIC || !workspace) {
+    state = gemm_blocked(m, n, k, 1.0, a, lda, 1, b, ldb, 1, 0.0, c, ldc);
+  } else {
+    matrix_arena_mark_t mark = arena_mark(matrix_scratch());
+    // whole recursion shares one block: calls at one level run one by one
+    double *temporaries =
+        (double *)arena_alloc(matrix_scratch(), sizeof(double) * workspace);
+    state = temporaries ? strassen_multiply(m, n, k, a, lda, b, ldb, c, ldc,
+                                            temporaries, cutoff)
+                        : gemm_blocked(m, n, k, 1.0, a, lda, 1, b, ldb, 1, 0.0,
+                                       c, ldc);
+    arena_reset(matrix_scratch(), mark);
+  }
+
+  return state;
+}
@@ -13,7 +13,7 @@ START_TEST(create_1) {
       }
     }
   }
-  if (A.matrix_type != ZERO_MATRIX) {
+  if (get_matrix_type(&A) != ZERO_MATRIX) {
     res1 = 0;
   }
   ck_assert_int_eq(res, 1);
@@ -28,7 +28,7 @@ START_TEST(create_2) {
   matrix_t A;
   A = create_matrix(0, -1);
   int res = 1;
-  if (A.matrix_type != INCORRECT_MATRIX) {
+  if (get_matrix_type(&A) != INCORRECT_MATRIX) {
     res = 0;
   }
   ck_assert_int_eq(res, 1);
@@ -41,14 +41,29 @@ END_TEST
 START_TEST(create_3) {
   matrix_t a = {0};
   a = create_matrix(1, 1);
-  ck_assert_int_eq(a.matrix_type, ZERO_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&a), ZERO_MATRIX);
   matrix_t a1 = {0};
   a1 = create_matrix(-1, -2);
-  ck_assert_int_eq(a1.matrix_type, INCORRECT_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&a1), INCORRECT_MATRIX);
   remove_matrix(&a);
 }
 END_TEST
 
+START_TEST(create_4) {
+  matrix_t a = create_matrix(5, 3);
+  double *data = matrix_data(&a);
+  ck_assert_int_eq((size_t)data % MATRIX_ALIGNMENT, 0);
+  ck_assert_int_eq(matrix_stride(&a), 3);
+  for (int i = 0; i < a.rows; i++) {
+    ck_assert_int_eq(a.matrix[i] - data, i * matrix_stride(&a));
+  }
+  a.matrix[4][2] = 7.5;
+  ck_assert_float_eq(data[4 * 3 + 2], 7.5);
+  remove_matrix(&a);
+  ck_assert_int_eq(matrix_data(&a) == NULL, 1);
+}
+END_TEST
+
 START_TEST(rem_1) {
   matrix_t a = create_matrix(1, 1);
   remove_matrix(&a);
@@ -155,8 +170,8 @@ START_TEST(sum_1) {
   F = sum_matrix(&A, &E);
   int res = eq_matrix(&C, &D);
   ck_assert_int_eq(res, 1);
-  ck_assert_int_eq(D.matrix_type, 0);
-  ck_assert_int_eq(F.matrix_type, 1);
+  ck_assert_int_eq(get_matrix_type(&D), 0);
+  ck_assert_int_eq(get_matrix_type(&F), 1);
   remove_matrix(&A);
   remove_matrix(&B);
   remove_matrix(&C);
@@ -172,17 +187,17 @@ START_TEST(sum_2) {
   a.matrix[0][0] = 1;
   a.matrix[1][1] = 1;
   matrix_t c = sum_matrix(&a, &b);
-  ck_assert_int_eq(c.matrix_type, IDENTITY_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&c), IDENTITY_MATRIX);
   remove_matrix(&c);
 
   matrix_t d = create_matrix(2, 3);
   c = sum_matrix(&a, &d);
-  ck_assert_int_eq(c.matrix_type, INCORRECT_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&c), INCORRECT_MATRIX);
   remove_matrix(&c);
 
   matrix_t f = create_matrix(2, 2);
   c = sum_matrix(&a, &f);
-  ck_assert_int_eq(c.matrix_type, 2);
+  ck_assert_int_eq(get_matrix_type(&c), 2);
   remove_matrix(&a);
   remove_matrix(&b);
   remove_matrix(&c);
@@ -231,8 +246,8 @@ START_TEST(sub_1) {
   F = sub_matrix(&A, &E);
   int res = eq_matrix(&C, &D);
   ck_assert_int_eq(res, 1);
-  ck_assert_int_eq(D.matrix_type, 2);
-  ck_assert_int_eq(F.matrix_type, 1);
+  ck_assert_int_eq(get_matrix_type(&D), 2);
+  ck_assert_int_eq(get_matrix_type(&F), 1);
   remove_matrix(&A);
   remove_matrix(&B);
   remove_matrix(&C);
@@ -270,7 +285,7 @@ START_TEST(sub_2) {
   D = sub_matrix(&A, &B);
   int res = eq_matrix(&C, &D);
   ck_assert_int_eq(res, 1);
-  ck_assert_int_eq(D.matrix_type, 3);
+  ck_assert_int_eq(get_matrix_type(&D), 3);
   remove_matrix(&A);
   remove_matrix(&B);
   remove_matrix(&C);
@@ -287,17 +302,17 @@ START_TEST(sub_3) {
   b.matrix[1][1] = 1;
   matrix_t c;
   c = sub_matrix(&a, &b);
-  ck_assert_int_eq(c.matrix_type, IDENTITY_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&c), IDENTITY_MATRIX);
   remove_matrix(&c);
   matrix_t d = create_matrix(2, 3);
   c = sub_matrix(&a, &d);
-  ck_assert_int_eq(c.matrix_type, 1);
+  ck_assert_int_eq(get_matrix_type(&c), 1);
   remove_matrix(&c);
   matrix_t f = create_matrix(2, 2);
   remove_matrix(&f);
   f.matrix_type = INCORRECT_MATRIX;
   c = sub_matrix(&a, &f);
-  ck_assert_int_eq(c.matrix_type, INCORRECT_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&c), INCORRECT_MATRIX);
   remove_matrix(&a);
   remove_matrix(&b);
   remove_matrix(&c);
@@ -335,7 +350,7 @@ START_TEST(mult_num_2) {
   a.matrix[0][0] = 1;
   a.matrix[1][1] = 1;
   c = mult_number(&a, 1);
-  ck_assert_int_eq(c.matrix_type, IDENTITY_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&c), IDENTITY_MATRIX);
   remove_matrix(&c);
   c = mult_number(&a, 2);
   int check = 0;
@@ -355,7 +370,7 @@ START_TEST(mult_num_2) {
   remove_matrix(&a);
   a.matrix_type = INCORRECT_MATRIX;
   c = mult_number(&a, 2);
-  ck_assert_int_eq(c.matrix_type, INCORRECT_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&c), INCORRECT_MATRIX);
   remove_matrix(&c);
 }
 END_TEST
@@ -393,8 +408,8 @@ START_TEST(mult_m_1) {
   F = mult_matrix(&A, &E);
   int res = eq_matrix(&C, &D);
   ck_assert_int_eq(res, 1);
-  ck_assert_int_eq(C.matrix_type, 0);
-  ck_assert_int_eq(F.matrix_type, 1);
+  ck_assert_int_eq(get_matrix_type(&C), 0);
+  ck_assert_int_eq(get_matrix_type(&F), 1);
   remove_matrix(&A);
   remove_matrix(&B);
   remove_matrix(&C);
@@ -447,7 +462,7 @@ START_TEST(mult_m_2) {
   remove_matrix(&a);
   a.matrix_type = INCORRECT_MATRIX;
   c = mult_matrix(&a, &b);
-  ck_assert_int_eq(c.matrix_type, INCORRECT_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&c), INCORRECT_MATRIX);
   remove_matrix(&c);
   remove_matrix(&b);
   remove_matrix(&res);
@@ -456,12 +471,37 @@ START_TEST(mult_m_2) {
   m1.matrix_type = INCORRECT_MATRIX;
   matrix_t m2 = create_matrix(2, 4);
   matrix_t m3 = mult_matrix(&m1, &m2);
-  ck_assert_int_eq(m3.matrix_type, INCORRECT_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&m3), INCORRECT_MATRIX);
   remove_matrix(&m3);
   remove_matrix(&m2);
 }
 END_TEST
 
+START_TEST(mult_m_3) {
+  matrix_t a = create_matrix(103, 131), b = create_matrix(131, 77);
+  for (int i = 0; i < a.rows; i++)
+    for (int j = 0; j < a.columns; j++) a.matrix[i][j] = (i * 7 + j * 3) % 11 - 5;
+  for (int i = 0; i < b.rows; i++)
+    for (int j = 0; j < b.columns; j++) b.matrix[i][j] = (i * 5 + j) % 13 * 0.25;
+  matrix_t c = mult_matrix(&a, &b);
+  ck_assert_int_eq(c.rows, 103);
+  ck_assert_int_eq(c.columns, 77);
+  int equal = 1;
+  for (int i = 0; i < c.rows; i++) {
+    for (int j = 0; j < c.columns; j++) {
+      double expected = 0;
+      for (int k = 0; k < a.columns; k++)
+        expected += a.matrix[i][k] * b.matrix[k][j];
+      equal = equal && fabs(c.matrix[i][j] - expected) < ACCURACY;
+    }
+  }
+  ck_assert_int_eq(equal, 1);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+}
+END_TEST
+
 START_TEST(trans_1) {
   matrix_t A, B, C;
   A = create_matrix(3, 3);
@@ -544,9 +584,9 @@ START_TEST(calc_compl_1) {
   C.matrix_type = 0;
   int res = eq_matrix(&B, &C);
   ck_assert_int_eq(res, 1);
-  ck_assert_int_eq(B.matrix_type, 0);
+  ck_assert_int_eq(get_matrix_type(&B), 0);
   E = calc_complements(&D);
-  ck_assert_int_eq(E.matrix_type, 1);
+  ck_assert_int_eq(get_matrix_type(&E), 1);
   remove_matrix(&A);
   remove_matrix(&B);
   remove_matrix(&C);
@@ -740,9 +780,9 @@ START_TEST(inverse_2) {
   int res = eq_matrix(&B, &C);
   ck_assert_int_eq(res, 1);
   E = inverse_matrix(&D);
-  ck_assert_int_eq(E.matrix_type, 1);
+  ck_assert_int_eq(get_matrix_type(&E), 1);
   G = inverse_matrix(&F);
-  ck_assert_int_eq(G.matrix_type, 1);
+  ck_assert_int_eq(get_matrix_type(&G), 1);
   remove_matrix(&A);
   remove_matrix(&B);
   remove_matrix(&C);
@@ -781,12 +821,12 @@ START_TEST(inverse_3) {
   matrix_t a_obr = inverse_matrix(&a);
 
   ck_assert_int_eq(eq_matrix(&res, &a_obr), SUCCESS);
-  ck_assert_int_eq(a_obr.matrix_type, CORRECT_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&a_obr), CORRECT_MATRIX);
   remove_matrix(&a_obr);
 
   a.matrix_type = INCORRECT_MATRIX;
   a_obr = inverse_matrix(&a);
-  ck_assert_int_eq(a_obr.matrix_type, INCORRECT_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&a_obr), INCORRECT_MATRIX);
 
   remove_matrix(&a);
   remove_matrix(&res);
@@ -906,7 +946,7 @@ START_TEST(sum_matrix_2) {
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix2.matrix_type = CORRECT_MATRIX;
   matrix_t result = sum_matrix(&matrix1, &matrix2);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&matrix2);
   remove_matrix(&result);
@@ -982,7 +1022,7 @@ START_TEST(sum_matrix_5) {
   matrix2.matrix[1][1] = 1.9473702;
   matrix2.matrix_type = CORRECT_MATRIX;
   matrix_t result = sum_matrix(&matrix1, &matrix2);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&matrix2);
   remove_matrix(&result);
@@ -1001,7 +1041,7 @@ START_TEST(sum_matrix_6) {
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix2.matrix_type = CORRECT_MATRIX;
   matrix_t result = sum_matrix(&matrix1, &matrix2);
-  fail_if(result.matrix_type != ZERO_MATRIX);
+  fail_if(get_matrix_type(&result) != ZERO_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&matrix2);
   remove_matrix(&result);
@@ -1058,7 +1098,7 @@ START_TEST(sub_matrix_2) {
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix2.matrix_type = CORRECT_MATRIX;
   matrix_t result = sub_matrix(&matrix1, &matrix2);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&matrix2);
   remove_matrix(&result);
@@ -1135,7 +1175,7 @@ START_TEST(sub_matrix_5) {
   matrix2.matrix[1][1] = 1.9473702;
   matrix2.matrix_type = CORRECT_MATRIX;
   matrix_t result = sub_matrix(&matrix1, &matrix2);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&matrix2);
   remove_matrix(&result);
@@ -1195,7 +1235,7 @@ START_TEST(mult_number_3) {
   matrix_t matrix1 = create_matrix(0, 0);
   double number = 2.528973;
   matrix_t result = mult_number(&matrix1, number);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
@@ -1211,7 +1251,7 @@ START_TEST(mult_number_4) {
   double number = NAN;
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix_t result = mult_number(&matrix1, number);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
@@ -1270,7 +1310,7 @@ START_TEST(mult_matrix_2) {
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix2.matrix_type = CORRECT_MATRIX;
   matrix_t result = mult_matrix(&matrix1, &matrix2);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&matrix2);
   remove_matrix(&result);
@@ -1345,7 +1385,7 @@ START_TEST(mult_matrix_5) {
   }
   matrix2.matrix_type = CORRECT_MATRIX;
   matrix_t result = mult_matrix(&matrix1, &matrix2);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&matrix2);
   remove_matrix(&result);
@@ -1424,7 +1464,7 @@ END_TEST
 START_TEST(transpose_4) {
   matrix_t matrix1 = create_matrix(0, 0);
   matrix_t result = transpose(&matrix1);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
@@ -1466,7 +1506,7 @@ START_TEST(calc_complements_2) {
   }
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix_t result = calc_complements(&matrix1);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
@@ -1481,7 +1521,7 @@ START_TEST(calc_complements_3) {
   }
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix_t result = calc_complements(&matrix1);
-  fail_if(!(result.matrix_type != INCORRECT_MATRIX));
+  fail_if(!(get_matrix_type(&result) != INCORRECT_MATRIX));
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
@@ -1490,7 +1530,7 @@ END_TEST
 START_TEST(calc_complements_4) {
   matrix_t matrix1 = create_matrix(0, 0);
   matrix_t result = calc_complements(&matrix1);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
@@ -1660,7 +1700,7 @@ START_TEST(inverse_matrix_1) {
   }
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix_t result = inverse_matrix(&matrix1);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
@@ -1680,7 +1720,7 @@ START_TEST(inverse_matrix_2) {
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix_t result = inverse_matrix(&matrix1);
   matrix_t checker = mult_matrix(&result, &matrix1);
-  fail_if(checker.matrix_type != IDENTITY_MATRIX);
+  fail_if(get_matrix_type(&checker) != IDENTITY_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
   remove_matrix(&checker);
@@ -1696,7 +1736,7 @@ START_TEST(inverse_matrix_3) {
   }
   matrix1.matrix_type = CORRECT_MATRIX;
   matrix_t result = inverse_matrix(&matrix1);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
@@ -1705,12 +1745,1083 @@ END_TEST
 START_TEST(inverse_matrix_4) {
   matrix_t matrix1 = create_matrix(0, 0);
   matrix_t result = inverse_matrix(&matrix1);
-  fail_if(result.matrix_type != INCORRECT_MATRIX);
+  fail_if(get_matrix_type(&result) != INCORRECT_MATRIX);
   remove_matrix(&matrix1);
   remove_matrix(&result);
 }
 END_TEST
 
+START_TEST(inverse_matrix_5) {
+  matrix_t a = create_matrix(120, 120);
+  for (int i = 0; i < a.rows; i++)
+    for (int j = 0; j < a.columns; j++)
+      a.matrix[i][j] = (i == j) * 50.0 + (i * 31 + j * 17) % 19 - 9;
+  a.matrix_type = CORRECT_MATRIX;
+  matrix_t inverse = inverse_matrix(&a);
+  matrix_t checker = mult_matrix(&a, &inverse);
+  ck_assert_int_eq(get_matrix_type(&checker), IDENTITY_MATRIX);
+  remove_matrix(&checker);
+  remove_matrix(&inverse);
+  remove_matrix(&a);
+}
+END_TEST
+
+void complements_by_minors(matrix_t *a, matrix_t *res) {
+  matrix_t minor = create_matrix(a->rows - 1, a->columns - 1);
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      make_matrix_minor(*a, i, j, &minor);
+      res->matrix[i][j] = determinant(&minor) * ((i + j) % 2 ? -1 : 1);
+    }
+  }
+  remove_matrix(&minor);
+}
+
+START_TEST(calc_complements_6) {
+  matrix_t a = create_matrix(6, 6), expected = create_matrix(6, 6);
+  for (int i = 0; i < a.rows; i++)
+    for (int j = 0; j < a.columns; j++)
+      a.matrix[i][j] = (i * 7 + j * 5 + i * j) % 9 - 4 + (i == j) * 3;
+  a.matrix_type = CORRECT_MATRIX;
+  complements_by_minors(&a, &expected);
+  matrix_t result = calc_complements(&a);
+  ck_assert_int_eq(eq_matrix(&result, &expected), SUCCESS);
+  remove_matrix(&result);
+  // rank 5: last row repeats combination of first two rows
+  for (int j = 0; j < a.columns; j++)
+    a.matrix[5][j] = 2 * a.matrix[0][j] - a.matrix[1][j];
+  complements_by_minors(&a, &expected);
+  result = calc_complements(&a);
+  ck_assert_int_eq(eq_matrix(&result, &expected), SUCCESS);
+  ck_assert_int_ne(get_matrix_type(&result), ZERO_MATRIX);
+  remove_matrix(&result);
+  // rank 4: every cofactor vanishes
+  for (int j = 0; j < a.columns; j++) a.matrix[4][j] = a.matrix[2][j];
+  result = calc_complements(&a);
+  ck_assert_int_eq(get_matrix_type(&result), ZERO_MATRIX);
+  remove_matrix(&result);
+  remove_matrix(&expected);
+  remove_matrix(&a);
+}
+END_TEST
+
+// every cofactor matches the one expanded by minors up to relative error
+int complements_match(matrix_t *a) {
+  matrix_t expected = create_matrix(a->rows, a->columns);
+  matrix_t result = calc_complements(a);
+  int equal = result.matrix_type != INCORRECT_MATRIX;
+  complements_by_minors(a, &expected);
+  for (int i = 0; equal && i < a->rows; i++) {
+    for (int j = 0; equal && j < a->columns; j++) {
+      double e = expected.matrix[i][j], r = result.matrix[i][j];
+      equal = fabs(r - e) <= ACCURACY * fmax(1.0, fabs(e));
+    }
+  }
+  remove_matrix(&result);
+  remove_matrix(&expected);
+  return equal;
+}
+
+// exactly representable nonsingular inputs whose pivots differ by more than
+// 1 / DBL_EPSILON keep their cofactors
+START_TEST(calc_complements_7) {
+  matrix_t a = create_matrix(4, 4), b = create_matrix(5, 5), c;
+  for (int i = 0; i < 4; i++) a.matrix[i][i] = 1.0;
+  a.matrix[0][0] = 1e16;
+  a.matrix[0][1] = 1.0;
+  c = calc_complements(&a);
+  ck_assert_double_eq_tol(c.matrix[0][0], 1.0, 1e-7);
+  ck_assert_double_eq_tol(c.matrix[1][0], -1.0, 1e-7);
+  for (int i = 1; i < 4; i++) {
+    ck_assert_double_eq_tol(c.matrix[i][i] / 1e16, 1.0, 1e-7);
+  }
+  ck_assert_int_ne(get_matrix_type(&c), ZERO_MATRIX);
+  remove_matrix(&c);
+  ck_assert_int_eq(complements_match(&a), 1);
+  // column scaled both ways: det far above and far below ACCURACY
+  for (double scale = 1e16; scale > 1e-17; scale *= 1e-32) {
+    for (int i = 0; i < 5; i++) {
+      for (int j = 0; j < 5; j++) b.matrix[i][j] = (i * 3 + j * 7) % 13 - 6;
+      b.matrix[i][i] += 9;
+      b.matrix[i][0] *= scale;
+    }
+    ck_assert_int_eq(complements_match(&b), 1);
+  }
+  // triangular with tiny diagonal, singular for inverse_matrix()
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) {
+      b.matrix[i][j] = j < i ? 0 : (i + 2 * j) % 5 + 1;
+    }
+    b.matrix[i][i] = i % 2 ? 1e-5 : 1.0;
+  }
+  ck_assert_int_eq(complements_match(&b), 1);
+  remove_matrix(&a);
+  remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(simd_kernels_1) {
+  double a[37], b[37], res[37];
+  for (int i = 0; i < 37; i++) {
+    a[i] = i * 0.5;
+    b[i] = 37 - i;
+  }
+  ck_assert_int_eq(matrix_simd_level() != NULL, 1);
+  matrix_kernels.add(a, b, res, 37);
+  for (int i = 0; i < 37; i++) ck_assert_float_eq(res[i], a[i] + b[i]);
+  matrix_kernels.sub(a, b, res, 37);
+  for (int i = 0; i < 37; i++) ck_assert_float_eq(res[i], a[i] - b[i]);
+  matrix_kernels.scale(a, -2, res, 37);
+  for (int i = 0; i < 37; i++) ck_assert_float_eq(res[i], a[i] * -2);
+  matrix_kernels.axpy(3, a, res, 37);
+  for (int i = 0; i < 37; i++) ck_assert_float_eq(res[i], a[i]);
+  ck_assert_int_eq(matrix_kernels.compare(a, res, 37, ACCURACY), 1);
+  res[36] += 0.001;
+  ck_assert_int_eq(matrix_kernels.compare(a, res, 37, ACCURACY), 0);
+  res[36] = a[36];
+  res[3] = NAN;
+  ck_assert_int_eq(matrix_kernels.compare(a, res, 37, ACCURACY), 0);
+}
+END_TEST
+
+START_TEST(lazy_type_1) {
+  matrix_t a = create_matrix(3, 3);
+  for (int i = 0; i < 3; i++) a.matrix[i][i] = 1;
+  touch_matrix(&a);
+  ck_assert_int_eq(get_matrix_type(&a), IDENTITY_MATRIX);
+  matrix_t b = sum_matrix(&a, &a);
+  ck_assert_int_eq(b.matrix_type, UNKNOWN_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&b), CORRECT_MATRIX);
+  ck_assert_int_eq(b.matrix_type, CORRECT_MATRIX);
+  matrix_t c = transpose(&a);
+  ck_assert_int_eq(c.matrix_type, IDENTITY_MATRIX);
+  matrix_t d = mult_number(&b, 0);
+  ck_assert_int_eq(d.matrix_type, UNKNOWN_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&d), ZERO_MATRIX);
+  remove_matrix(&d);
+  d = mult_number(&c, 0);
+  ck_assert_int_eq(d.matrix_type, ZERO_MATRIX);
+  remove_matrix(&d);
+  matrix_t e = mult_number(&b, 0.5);
+  ck_assert_int_eq(e.matrix_type, UNKNOWN_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&e), IDENTITY_MATRIX);
+  // infinity passes validation, and infinity * 0 stays NaN
+  b.matrix[0][1] = INFINITY;
+  touch_matrix(&b);
+  d = mult_number(&b, 0);
+  ck_assert_msg(isnan(d.matrix[0][1]), "inf * 0 is nan");
+  ck_assert_double_eq_tol(d.matrix[1][1], 0.0, 1e-7);
+  ck_assert_int_eq(get_matrix_type(&d), INCORRECT_MATRIX);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+  remove_matrix(&d);
+  remove_matrix(&e);
+}
+END_TEST
+
+START_TEST(lazy_type_2) {
+  // create_matrix() stamps ZERO_MATRIX, touch_matrix() drops the stamp
+  matrix_t a = create_matrix(3, 3);
+  for (int i = 0; i < 3; i++) a.matrix[i][i] = 1;
+  touch_matrix(&a);
+  ck_assert_int_eq(get_matrix_type(&a), IDENTITY_MATRIX);
+  // stamped type is classified again and does not reach results
+  matrix_t b = create_matrix(2, 2);
+  b.matrix[0][0] = INFINITY;
+  matrix_t c = mult_number(&b, 0);
+  ck_assert_int_eq(c.matrix_type, UNKNOWN_MATRIX);
+  ck_assert_int_eq(get_matrix_type(&c), INCORRECT_MATRIX);
+  remove_matrix(&c);
+  b.matrix_type = IDENTITY_MATRIX;
+  b.matrix[0][0] = 2;
+  c = transpose(&b);
+  ck_assert_int_eq(get_matrix_type(&c), CORRECT_MATRIX);
+  remove_matrix(&c);
+  // edited identity loses its type on touch
+  a.matrix[0][1] = 5;
+  touch_matrix(&a);
+  c = transpose(&a);
+  ck_assert_int_eq(get_matrix_type(&c), CORRECT_MATRIX);
+  ck_assert_double_eq_tol(c.matrix[1][0], 5.0, 1e-7);
+  remove_matrix(&c);
+  c = inverse_matrix(&a);
+  ck_assert_int_eq(get_matrix_type(&c), CORRECT_MATRIX);
+  ck_assert_double_eq_tol(c.matrix[0][1], -5.0, 1e-7);
+  remove_matrix(&c);
+  c = mult_matrix(&a, &a);
+  ck_assert_int_eq(get_matrix_type(&c), CORRECT_MATRIX);
+  ck_assert_double_eq_tol(c.matrix[0][1], 10.0, 1e-7);
+  remove_matrix(&c);
+  c = matrix_parallel_mult(&a, &a);
+  ck_assert_int_eq(get_matrix_type(&c), CORRECT_MATRIX);
+  remove_matrix(&c);
+  remove_matrix(&a);
+  remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(validation_1) {
+  matrix_t a = create_matrix(2, 2), b = create_matrix(2, 2), c;
+  a.matrix[1][1] = NAN;
+  c = sum_matrix(&a, &b);
+  ck_assert_int_eq(get_matrix_type(&c), INCORRECT_MATRIX);
+  set_matrix_validation(VALIDATION_TRUSTED);
+  ck_assert_int_eq(get_matrix_validation(), VALIDATION_TRUSTED);
+  c = sum_matrix(&a, &b);
+  ck_assert_int_eq(c.rows, 2);
+  remove_matrix(&c);
+  set_matrix_validation(VALIDATION_CACHED);
+  a.matrix[1][1] = 1;
+  c = sum_matrix(&a, &b);
+  ck_assert_int_eq(a.validated, 1);
+  remove_matrix(&c);
+  a.matrix[1][1] = NAN;
+  c = sum_matrix(&a, &b);
+  ck_assert_int_eq(c.rows, 2);
+  remove_matrix(&c);
+  touch_matrix(&a);
+  c = sum_matrix(&a, &b);
+  ck_assert_int_eq(get_matrix_type(&c), INCORRECT_MATRIX);
+  set_matrix_validation(VALIDATION_CHECKED);
+  remove_matrix(&a);
+  remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(into_1) {
+  matrix_t a = create_matrix(3, 3), b = create_matrix(3, 3);
+  matrix_t out = create_matrix(3, 3), expected;
+  matrix_alloc_stats_t before, after;
+  double values[9] = {2, 5, 7, 6, 3, 4, 5, -2, -3};
+  for (int i = 0; i < 9; i++) {
+    a.matrix[i / 3][i % 3] = values[i];
+    b.matrix[i % 3][i / 3] = values[i] - 1;
+  }
+  before = get_matrix_alloc_stats();
+  ck_assert_int_eq(sum_matrix_into(&a, &b, &out), SUCCESS);
+  after = get_matrix_alloc_stats();
+  ck_assert_int_eq(after.allocations, before.allocations);
+  expected = sum_matrix(&a, &b);
+  ck_assert_int_eq(eq_matrix(&out, &expected), SUCCESS);
+  remove_matrix(&expected);
+  ck_assert_int_eq(mult_matrix_into(&a, &b, &out), SUCCESS);
+  expected = mult_matrix(&a, &b);
+  ck_assert_int_eq(eq_matrix(&out, &expected), SUCCESS);
+  remove_matrix(&expected);
+  ck_assert_int_eq(calc_complements_into(&a, &out), SUCCESS);
+  expected = calc_complements(&a);
+  ck_assert_int_eq(eq_matrix(&out, &expected), SUCCESS);
+  remove_matrix(&expected);
+  ck_assert_int_eq(inverse_matrix_into(&a, &out), SUCCESS);
+  expected = inverse_matrix(&a);
+  ck_assert_int_eq(eq_matrix(&out, &expected), SUCCESS);
+  remove_matrix(&expected);
+  expected = transpose(&a);
+  ck_assert_int_eq(transpose_into(&a, &a), SUCCESS);
+  ck_assert_int_eq(eq_matrix(&a, &expected), SUCCESS);
+  remove_matrix(&expected);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&out);
+}
+END_TEST
+
+START_TEST(into_2) {
+  matrix_t a = create_matrix(2, 3), b = create_matrix(3, 2);
+  matrix_t square = create_matrix(2, 2), wrong = create_matrix(3, 3);
+  ck_assert_int_eq(sum_matrix_into(&a, &a, &wrong), FAILURE);
+  ck_assert_int_eq(sum_matrix_into(&a, &a, NULL), FAILURE);
+  ck_assert_int_eq(mult_matrix_into(&a, &b, &wrong), FAILURE);
+  ck_assert_int_eq(mult_matrix_into(&square, &square, &square), FAILURE);
+  ck_assert_int_eq(transpose_into(&a, &a), FAILURE);
+  ck_assert_int_eq(transpose_into(&a, &b), SUCCESS);
+  ck_assert_int_eq(inverse_matrix_into(&square, &square), FAILURE);
+  ck_assert_int_eq(get_matrix_type(&square), ZERO_MATRIX);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&square);
+  remove_matrix(&wrong);
+}
+END_TEST
+
+START_TEST(inplace_1) {
+  matrix_t a = create_matrix(4, 5), b = create_matrix(4, 5);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 5; j++) {
+      a.matrix[i][j] = i + j;
+      b.matrix[i][j] = i - j;
+    }
+  }
+  ck_assert_int_eq(sum_matrix_inplace(&a, &b), SUCCESS);
+  ck_assert_double_eq_tol(a.matrix[3][4], 6, 1e-7);
+  ck_assert_int_eq(sub_matrix_inplace(&a, &b), SUCCESS);
+  ck_assert_double_eq_tol(a.matrix[3][4], 7, 1e-7);
+  ck_assert_int_eq(mult_number_inplace(&a, -2), SUCCESS);
+  ck_assert_double_eq_tol(a.matrix[3][4], -14, 1e-7);
+  ck_assert_int_eq(get_matrix_type(&a), CORRECT_MATRIX);
+  ck_assert_int_eq(mult_number_inplace(&a, 0), SUCCESS);
+  ck_assert_int_eq(get_matrix_type(&a), ZERO_MATRIX);
+  remove_matrix(&a);
+  remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(arena_1) {
+  matrix_arena_t arena = create_arena(1024);
+  matrix_arena_mark_t mark = arena_mark(&arena);
+  matrix_alloc_stats_t before, after;
+  matrix_t a = create_matrix_in(&arena, 3, 3), b, c;
+  ck_assert_int_eq(a.in_arena, 1);
+  ck_assert_int_eq((size_t)a.data % MATRIX_ALIGNMENT, 0);
+  for (int i = 0; i < 3; i++) a.matrix[i][i] = i + 1;
+  set_matrix_arena(&arena);
+  b = mult_number(&a, 2);
+  set_matrix_arena(NULL);
+  ck_assert_int_eq(b.in_arena, 1);
+  ck_assert_double_eq_tol(b.matrix[2][2], 6, 1e-7);
+  arena_reset(&arena, mark);
+  before = get_matrix_alloc_stats();
+  for (int k = 0; k < 100; k++) {
+    mark = arena_mark(&arena);
+    c = create_matrix_in(&arena, 100, 100);
+    ck_assert_ptr_nonnull(c.matrix);
+    remove_matrix(&c);
+    arena_reset(&arena, mark);
+  }
+  after = get_matrix_alloc_stats();
+  ck_assert_int_le(after.allocations - before.allocations, 1);
+  remove_arena(&arena);
+  ck_assert_ptr_null(arena.chunk);
+  ck_assert_ptr_null(arena.spare);
+}
+END_TEST
+
+START_TEST(arena_2) {
+  matrix_t a = create_matrix(5, 5), b;
+  matrix_alloc_stats_t before, after;
+  double det = 0.0;
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) a.matrix[i][j] = (i * 7 + j * 3) % 5 + (i == j);
+  }
+  b = calc_complements(&a);
+  det = determinant(&a);
+  remove_matrix(&b);
+  before = get_matrix_alloc_stats();
+  ck_assert_double_eq_tol(determinant(&a), det, 1e-7);
+  after = get_matrix_alloc_stats();
+  ck_assert_int_eq(after.allocations, before.allocations);
+  b = calc_complements(&a);
+  after = get_matrix_alloc_stats();
+  ck_assert_int_eq(after.allocations, before.allocations + 1);
+  remove_matrix(&b);
+  remove_matrix(&a);
+  release_matrix_scratch();
+}
+END_TEST
+
+START_TEST(cache_1) {
+  matrix_alloc_stats_t before, after;
+  matrix_cache_stats_t start = get_matrix_cache_stats(), stats;
+  matrix_t a;
+  set_matrix_cache_limit(1 << 20);
+  ck_assert_int_eq(get_matrix_cache_limit(), 1 << 20);
+  before = get_matrix_alloc_stats();
+  for (int k = 0; k < 100; k++) {
+    a = create_matrix(10, 20);
+    ck_assert_double_eq_tol(a.matrix[9][19], 0, 1e-7);
+    a.matrix[9][19] = k + 1;
+    remove_matrix(&a);
+  }
+  after = get_matrix_alloc_stats();
+  stats = get_matrix_cache_stats();
+  ck_assert_int_eq(after.allocations - before.allocations, 1);
+  ck_assert_int_eq(stats.hits - start.hits, 99);
+  ck_assert_int_eq(stats.misses - start.misses, 1);
+  ck_assert_int_eq(stats.buffers, 1);
+  set_matrix_cache_limit(0);
+  stats = get_matrix_cache_stats();
+  ck_assert_int_eq(stats.buffers, 0);
+  ck_assert_int_eq(stats.bytes, 0);
+}
+END_TEST
+
+START_TEST(cache_2) {
+  matrix_t a = create_matrix(64, 64), b = create_matrix(64, 64);
+  matrix_t c = create_matrix(64, 64);
+  size_t size = 0;
+  set_matrix_cache_limit(1);
+  remove_matrix(&a);
+  ck_assert_int_eq(get_matrix_cache_stats().buffers, 0);
+  a = create_matrix(64, 64);
+  size = matrix_storage_size(64, 64);
+  set_matrix_cache_limit(2 * size);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+  ck_assert_int_eq(get_matrix_cache_stats().buffers, 2);
+  ck_assert_int_eq(get_matrix_cache_stats().bytes, 2 * size);
+  set_matrix_cache_limit(size);
+  ck_assert_int_eq(get_matrix_cache_stats().buffers, 1);
+  set_matrix_cache_limit(0);
+}
+END_TEST
+
+START_TEST(view_1) {
+  matrix_t a = create_matrix(5, 5), minor = create_matrix(4, 4), b;
+  matrix_alloc_stats_t before, after;
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) a.matrix[i][j] = (i * 3 + j * 7) % 11 - 5;
+  }
+  make_matrix_minor(a, 1, 2, &minor);
+  ck_assert_int_eq(eq_matrix_view(view_minor(&a, 1, 2), view_matrix(&minor)),
+                   SUCCESS);
+  b = transpose_view(view_minor(&a, 1, 2));
+  ck_assert_int_eq(b.rows, 4);
+  ck_assert_double_eq_tol(b.matrix[2][1], a.matrix[2][3], 1e-7);
+  remove_matrix(&b);
+  before = get_matrix_alloc_stats();
+  ck_assert_double_eq_tol(determinant_view(view_submatrix(&a, 0, 1, 3, 3)),
+                          a.matrix[0][1] * (a.matrix[1][2] * a.matrix[2][3] -
+                                            a.matrix[2][2] * a.matrix[1][3]) -
+                              a.matrix[0][2] *
+                                  (a.matrix[1][1] * a.matrix[2][3] -
+                                   a.matrix[2][1] * a.matrix[1][3]) +
+                              a.matrix[0][3] *
+                                  (a.matrix[1][1] * a.matrix[2][2] -
+                                   a.matrix[2][1] * a.matrix[1][2]),
+                          1e-7);
+  after = get_matrix_alloc_stats();
+  ck_assert_int_eq(after.allocations, before.allocations);
+  ck_assert_int_eq(view_submatrix(&a, 3, 0, 3, 1).origin == NULL, 1);
+  ck_assert_int_eq(isnan(determinant_view(view_submatrix(&a, 0, 0, 2, 3))), 1);
+  remove_matrix(&a);
+  remove_matrix(&minor);
+}
+END_TEST
+
+START_TEST(view_2) {
+  matrix_t a = create_matrix(12, 12), b = create_matrix(12, 12), c, d, e;
+  for (int i = 0; i < 12; i++) {
+    for (int j = 0; j < 12; j++) {
+      a.matrix[i][j] = (i * 5 + j * 3) % 7 - 3;
+      b.matrix[i][j] = (i * 2 + j * 9) % 5 - 2 + (i == j);
+    }
+  }
+  c = mult_matrix_view(view_submatrix(&a, 2, 1, 5, 11),
+                       view_minor(&b, 4, 3));
+  ck_assert_int_eq(c.rows, 5);
+  ck_assert_int_eq(c.columns, 11);
+  d = create_matrix(11, 11);
+  make_matrix_minor(b, 4, 3, &d);
+  e = create_matrix(5, 11);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 11; j++) e.matrix[i][j] = a.matrix[i + 2][j + 1];
+  }
+  ck_assert_double_eq_tol(determinant_view(view_minor(&b, 4, 3)),
+                          determinant(&d), 1e-6);
+  remove_matrix(&d);
+  d = mult_matrix_view(view_matrix(&e), view_minor(&b, 4, 3));
+  ck_assert_int_eq(eq_matrix(&c, &d), SUCCESS);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+  remove_matrix(&d);
+  remove_matrix(&e);
+}
+END_TEST
+
+START_TEST(transpose_5) {
+  matrix_t a = create_matrix(100, 70), b, c = create_matrix(97, 97), d;
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 70; j++) a.matrix[i][j] = i * 1000 + j;
+  }
+  for (int i = 0; i < 97; i++) {
+    for (int j = 0; j < 97; j++) c.matrix[i][j] = i * 1000 + j;
+  }
+  b = transpose(&a);
+  d = transpose(&c);
+  ck_assert_int_eq(transpose_into(&c, &c), SUCCESS);
+  ck_assert_int_eq(eq_matrix(&c, &d), SUCCESS);
+  for (int i = 0; i < 70; i++) {
+    for (int j = 0; j < 100; j++) {
+      ck_assert_double_eq_tol(b.matrix[i][j], j * 1000 + i, 1e-7);
+    }
+  }
+  for (int i = 0; i < 97; i++) {
+    for (int j = 0; j < 97; j++) {
+      ck_assert_double_eq_tol(c.matrix[i][j], j * 1000 + i, 1e-7);
+    }
+  }
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+  remove_matrix(&d);
+}
+END_TEST
+
+START_TEST(view_3) {
+  matrix_t a = create_matrix(40, 30), b = create_matrix(40, 20), c, d, e;
+  for (int i = 0; i < 40; i++) {
+    for (int j = 0; j < 30; j++) a.matrix[i][j] = (i * 5 + j * 3) % 7 - 3;
+    for (int j = 0; j < 20; j++) b.matrix[i][j] = (i * 2 + j * 9) % 5 - 2;
+  }
+  c = transpose(&a);
+  d = mult_matrix(&c, &b);
+  e = mult_matrix_view(view_transposed(view_matrix(&a)), view_matrix(&b));
+  ck_assert_int_eq(eq_matrix(&d, &e), SUCCESS);
+  ck_assert_int_eq(
+      eq_matrix_view(view_transposed(view_matrix(&a)), view_matrix(&c)),
+      SUCCESS);
+  remove_matrix(&e);
+  e = transpose_view(view_transposed(view_minor(&a, 3, 4)));
+  ck_assert_int_eq(eq_matrix_view(view_matrix(&e), view_minor(&a, 3, 4)),
+                   SUCCESS);
+  ck_assert_double_eq_tol(
+      determinant_view(view_transposed(view_submatrix(&a, 5, 2, 6, 6))),
+      determinant_view(view_submatrix(&a, 5, 2, 6, 6)), 1e-6);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+  remove_matrix(&d);
+  remove_matrix(&e);
+}
+END_TEST
+
+void gemm_by_steps(int trans_a, int trans_b, double alpha, matrix_t *a,
+                   matrix_t *b, double beta, matrix_t *c, matrix_t *res) {
+  matrix_t op_a = trans_a ? transpose(a) : mult_number(a, 1);
+  matrix_t op_b = trans_b ? transpose(b) : mult_number(b, 1);
+  matrix_t product = mult_matrix(&op_a, &op_b);
+  matrix_t scaled = mult_number(&product, alpha);
+  matrix_t former = mult_number(c, beta);
+  *res = sum_matrix(&scaled, &former);
+  remove_matrix(&op_a);
+  remove_matrix(&op_b);
+  remove_matrix(&product);
+  remove_matrix(&scaled);
+  remove_matrix(&former);
+}
+
+START_TEST(gemm_1) {
+  int sizes[2][3] = {{5, 4, 3}, {70, 90, 50}};
+  for (int s = 0; s < 2; s++) {
+    int m = sizes[s][0], n = sizes[s][1], k = sizes[s][2];
+    for (int flags = 0; flags < 4; flags++) {
+      int trans_a = flags & 1, trans_b = flags >> 1;
+      matrix_t a = trans_a ? create_matrix(k, m) : create_matrix(m, k);
+      matrix_t b = trans_b ? create_matrix(n, k) : create_matrix(k, n);
+      matrix_t c = create_matrix(m, n), expected;
+      for (int i = 0; i < a.rows; i++) {
+        for (int j = 0; j < a.columns; j++) a.matrix[i][j] = (i + 2 * j) % 7;
+      }
+      for (int i = 0; i < b.rows; i++) {
+        for (int j = 0; j < b.columns; j++) b.matrix[i][j] = (3 * i + j) % 5;
+      }
+      for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) c.matrix[i][j] = i - j;
+      }
+      gemm_by_steps(trans_a, trans_b, -1.5, &a, &b, 0.5, &c, &expected);
+      ck_assert_int_eq(gemm_matrix(trans_a, trans_b, -1.5, &a, &b, 0.5, &c),
+                       SUCCESS);
+      ck_assert_int_eq(eq_matrix(&c, &expected), SUCCESS);
+      remove_matrix(&a);
+      remove_matrix(&b);
+      remove_matrix(&c);
+      remove_matrix(&expected);
+    }
+  }
+}
+END_TEST
+
+START_TEST(gemm_2) {
+  matrix_t a = create_matrix(3, 2), b = create_matrix(3, 4);
+  matrix_t c = create_matrix(2, 4);
+  for (int i = 0; i < 3; i++) {
+    a.matrix[i][0] = 1;
+    b.matrix[i][i] = 2;
+  }
+  c.matrix[1][1] = NAN;
+  ck_assert_int_eq(gemm_matrix(0, 0, 1, &a, &b, 0, &c), FAILURE);
+  ck_assert_int_eq(gemm_matrix(1, 0, 1, &a, &b, 1, &c), FAILURE);
+  ck_assert_int_eq(gemm_matrix(1, 0, 1, &a, &b, 0, &c), SUCCESS);
+  ck_assert_double_eq_tol(c.matrix[0][2], 2, 1e-7);
+  ck_assert_double_eq_tol(c.matrix[1][1], 0, 1e-7);
+  ck_assert_int_eq(gemm_matrix(0, 0, 1, &c, &c, 0, &c), FAILURE);
+  ck_assert_int_eq(gemm_matrix(1, 0, 0, &a, &b, 2, &c), SUCCESS);
+  ck_assert_double_eq_tol(c.matrix[0][2], 4, 1e-7);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+}
+END_TEST
+
+void fill_pattern(matrix_t *a, int seed) {
+  for (int i = 0; i < a->rows; i++) {
+    for (int j = 0; j < a->columns; j++) {
+      a->matrix[i][j] = (i * seed + j * 7) % 13 - 6;
+    }
+  }
+}
+
+START_TEST(threads_1) {
+  matrix_t a = create_matrix(150, 140), b = create_matrix(140, 130);
+  matrix_t c = create_matrix(300, 300), d = create_matrix(300, 300);
+  matrix_t e = create_matrix(300, 300), serial[4], parallel[4];
+  fill_pattern(&a, 3);
+  fill_pattern(&b, 5);
+  fill_pattern(&c, 11);
+  fill_pattern(&d, 2);
+  for (int i = 0; i < 300; i++) e.matrix[i][i] = 1;
+  e.matrix_type = UNKNOWN_MATRIX;
+  for (int run = 0; run < 2; run++) {
+    matrix_t *res = run ? parallel : serial;
+    set_matrix_threads(run ? 4 : 1);
+    res[0] = mult_matrix(&a, &b);
+    res[1] = sum_matrix(&c, &d);
+    res[2] = mult_number(&c, -0.5);
+    res[3] = transpose(&a);
+  }
+  ck_assert_int_eq(get_matrix_threads(), 4);
+  ck_assert_int_eq(get_matrix_type(&e), IDENTITY_MATRIX);
+  e.matrix[0][299] = 1;
+  e.matrix_type = UNKNOWN_MATRIX;
+  ck_assert_int_eq(get_matrix_type(&e), CORRECT_MATRIX);
+  e.matrix[299][0] = NAN;
+  e.matrix_type = UNKNOWN_MATRIX;
+  ck_assert_int_eq(get_matrix_type(&e), INCORRECT_MATRIX);
+  for (int i = 0; i < 4; i++) {
+    ck_assert_int_eq(eq_matrix(serial + i, parallel + i), SUCCESS);
+    remove_matrix(serial + i);
+    remove_matrix(parallel + i);
+  }
+  set_matrix_threads(0);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+  remove_matrix(&d);
+  remove_matrix(&e);
+}
+END_TEST
+
+void count_hits(void *arg, int begin, int end) {
+  int *hits = (int *)arg;
+  for (int i = begin; i < end; i++) hits[i]++;
+}
+
+void count_hits_nested(void *arg, int begin, int end) {
+  int *hits = (int *)arg;
+  parallel_for(end - begin, 1, count_hits, hits + begin);
+}
+
+START_TEST(threads_2) {
+  int hits[1000] = {0};
+  set_matrix_threads(3);
+  parallel_for(1000, 7, count_hits, hits);
+  parallel_for(1000, 7, count_hits_nested, hits);
+  parallel_for(0, 7, count_hits, hits);
+  for (int i = 0; i < 1000; i++) ck_assert_int_eq(hits[i], 2);
+  set_matrix_threads(1);
+  ck_assert_int_eq(get_matrix_threads(), 1);
+  set_matrix_threads(0);
+  ck_assert_int_ge(get_matrix_threads(), 1);
+}
+END_TEST
+
+START_TEST(parallel_1) {
+  matrix_t a = create_matrix(200, 200), b = create_matrix(200, 37);
+  matrix_t c = create_matrix(37, 600), serial[2], parallel[2];
+  double det_serial = 0, det_parallel = 0;
+  // off-diagonal rows sum below 1, so det(A) stays far from overflow
+  fill_pattern(&a, 3);
+  for (int i = 0; i < 200; i++) {
+    for (int j = 0; j < 200; j++) {
+      a.matrix[i][j] = (i == j) + a.matrix[i][j] / 1000;
+    }
+  }
+  fill_pattern(&b, 5);
+  fill_pattern(&c, 11);
+  for (int run = 0; run < 2; run++) {
+    matrix_t *res = run ? parallel : serial;
+    set_matrix_threads(run ? 4 : 1);
+    res[0] = run ? matrix_parallel_inverse(&a) : inverse_matrix(&a);
+    res[1] = run ? matrix_parallel_mult(&b, &c) : mult_matrix(&b, &c);
+    if (run) {
+      det_parallel = matrix_parallel_determinant(&a);
+    } else {
+      det_serial = determinant(&a);
+    }
+  }
+  ck_assert_int_ne(isfinite(det_serial), 0);
+  ck_assert_double_eq_tol(det_parallel / det_serial, 1, 1e-9);
+  for (int i = 0; i < 2; i++) {
+    ck_assert_int_eq(eq_matrix(serial + i, parallel + i), SUCCESS);
+    remove_matrix(serial + i);
+    remove_matrix(parallel + i);
+  }
+  set_matrix_threads(0);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&c);
+}
+END_TEST
+
+START_TEST(parallel_2) {
+  matrix_t a = create_matrix(70, 70), b = create_matrix(3, 3), c;
+  for (int i = 0; i < 70; i++) a.matrix[i][i % 69] = i + 1;
+  set_matrix_threads(3);
+  c = matrix_parallel_inverse(&a);
+  ck_assert_int_eq(c.matrix_type, INCORRECT_MATRIX);
+  ck_assert_double_eq_tol(matrix_parallel_determinant(&a), 0, 1e-7);
+  fill_pattern(&b, 2);
+  ck_assert_double_eq_tol(matrix_parallel_determinant(&b), determinant(&b),
+                          1e-7);
+  c = matrix_parallel_mult(&a, &b);
+  ck_assert_int_eq(c.matrix_type, INCORRECT_MATRIX);
+  ck_assert_msg(isnan(matrix_parallel_determinant(&c)), "determinant is nan");
+  set_matrix_threads(0);
+  remove_matrix(&a);
+  remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(parallel_3) {
+  matrix_t a = create_matrix(90, 90), b = create_matrix(40, 40);
+  matrix_t serial[2], parallel[2];
+  fill_pattern(&a, 3);
+  for (int i = 0; i < 90; i++) a.matrix[i][i] += 2;
+  fill_pattern(&b, 5);
+  // repeated row: rank n-1 cofactors come from complete pivoting
+  memcpy(b.matrix[39], b.matrix[0], sizeof(double) * 40);
+  b.matrix_type = UNKNOWN_MATRIX;
+  for (int run = 0; run < 2; run++) {
+    matrix_t *res = run ? parallel : serial;
+    set_matrix_threads(run ? 4 : 1);
+    res[0] = calc_complements(&a);
+    res[1] = calc_complements(&b);
+  }
+  ck_assert_double_eq_tol(determinant(&b), 0, 1e-7);
+  for (int i = 0; i < 2; i++) {
+    ck_assert_int_eq(eq_matrix(serial + i, parallel + i), SUCCESS);
+    remove_matrix(serial + i);
+    remove_matrix(parallel + i);
+  }
+  set_matrix_threads(0);
+  remove_matrix(&a);
+  remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(batch_1) {
+  for (int n = 1; n <= 5; n++) {
+    matrix_batch_t batch = create_batch(37, n, n), inverses;
+    double det[37];
+    for (int k = 0; k < 37; k++) {
+      matrix_t a = create_matrix(n, n);
+      fill_pattern(&a, k + 2);
+      for (int i = 0; i < n; i++) a.matrix[i][i] += k % 5;
+      // every tenth matrix is singular
+      if (k % 10 == 3) memset(a.matrix[n - 1], 0, sizeof(double) * n);
+      a.matrix_type = UNKNOWN_MATRIX;
+      ck_assert_int_eq(batch_set(&batch, k, &a), SUCCESS);
+      remove_matrix(&a);
+    }
+    ck_assert_int_eq(batch_determinant(&batch, det), SUCCESS);
+    inverses = batch_inverse(&batch);
+    ck_assert_ptr_nonnull(inverses.data);
+    for (int k = 0; k < 37; k++) {
+      matrix_t a = batch_get(&batch, k), b = batch_get(&inverses, k);
+      matrix_t expected = inverse_matrix(&a);
+      ck_assert_double_eq_tol(det[k], determinant(&a), 1e-6);
+      if (expected.matrix) {
+        ck_assert_int_eq(eq_matrix(&b, &expected), SUCCESS);
+      } else {
+        ck_assert_msg(isnan(b.matrix[0][0]), "singular lane is nan");
+      }
+      remove_matrix(&a);
+      remove_matrix(&b);
+      remove_matrix(&expected);
+    }
+    remove_batch(&batch);
+    remove_batch(&inverses);
+  }
+}
+END_TEST
+
+START_TEST(batch_2) {
+  matrix_batch_t a = create_batch(11, 3, 2), b = create_batch(11, 2, 4);
+  matrix_batch_t products, sums, wrong = create_batch(10, 3, 2);
+  double det[11];
+  for (int k = 0; k < 11; k++) {
+    matrix_t x = create_matrix(3, 2), y = create_matrix(2, 4);
+    fill_pattern(&x, k);
+    fill_pattern(&y, k + 3);
+    batch_set(&a, k, &x);
+    batch_set(&b, k, &y);
+    remove_matrix(&x);
+    remove_matrix(&y);
+  }
+  products = batch_mult(&a, &b);
+  sums = batch_sum(&a, &a);
+  for (int k = 0; k < 11; k++) {
+    matrix_t x = batch_get(&a, k), y = batch_get(&b, k);
+    matrix_t product = mult_matrix(&x, &y), sum = sum_matrix(&x, &x);
+    matrix_t batched_product = batch_get(&products, k);
+    matrix_t batched_sum = batch_get(&sums, k);
+    ck_assert_int_eq(eq_matrix(&product, &batched_product), SUCCESS);
+    ck_assert_int_eq(eq_matrix(&sum, &batched_sum), SUCCESS);
+    remove_matrix(&x);
+    remove_matrix(&y);
+    remove_matrix(&product);
+    remove_matrix(&sum);
+    remove_matrix(&batched_product);
+    remove_matrix(&batched_sum);
+  }
+  ck_assert_int_eq(batch_determinant(&a, det), FAILURE);
+  ck_assert_ptr_null(batch_sum(&a, &wrong).data);
+  ck_assert_ptr_null(batch_mult(&a, &a).data);
+  ck_assert_ptr_null(batch_get(&a, 11).matrix);
+  a.data[a.stride + 4] = NAN;
+  ck_assert_ptr_null(batch_sum(&a, &a).data);
+  remove_batch(&a);
+  remove_batch(&b);
+  remove_batch(&products);
+  remove_batch(&sums);
+  remove_batch(&wrong);
+}
+END_TEST
+
+START_TEST(fixed_1) {
+  mat2_t a2, b2, r2;
+  mat3_t a3, b3, r3;
+  mat4_t a4, b4, r4;
+  for (int n = 2; n <= 4; n++) {
+    matrix_t a = create_matrix(n, n), b = create_matrix(n, n), c, d;
+    double det = 0.0;
+    fill_pattern(&a, 3);
+    fill_pattern(&b, 5);
+    for (int i = 0; i < n; i++) a.matrix[i][i] += 7;
+    a.matrix_type = b.matrix_type = UNKNOWN_MATRIX;
+    matrix_t product = mult_matrix(&a, &b), inverse = inverse_matrix(&a);
+    matrix_t transposed = transpose(&a);
+    if (n == 2) {
+      mat2_from_matrix(&a, &a2);
+      mat2_from_matrix(&b, &b2);
+      r2 = mat2_mult(&a2, &b2);
+      c = mat2_to_matrix(&r2);
+      det = mat2_determinant(&a2);
+      r2 = mat2_transpose(&a2);
+      d = mat2_to_matrix(&r2);
+      ck_assert_int_eq(mat2_inverse(&a2, &a2), SUCCESS);
+      r2 = a2;
+    } else if (n == 3) {
+      mat3_from_matrix(&a, &a3);
+      mat3_from_matrix(&b, &b3);
+      r3 = mat3_mult(&a3, &b3);
+      c = mat3_to_matrix(&r3);
+      det = mat3_determinant(&a3);
+      r3 = mat3_transpose(&a3);
+      d = mat3_to_matrix(&r3);
+      ck_assert_int_eq(mat3_inverse(&a3, &r3), SUCCESS);
+    } else {
+      mat4_from_matrix(&a, &a4);
+      mat4_from_matrix(&b, &b4);
+      r4 = mat4_mult(&a4, &b4);
+      c = mat4_to_matrix(&r4);
+      det = mat4_determinant(&a4);
+      r4 = mat4_transpose(&a4);
+      d = mat4_to_matrix(&r4);
+      ck_assert_int_eq(mat4_inverse(&a4, &a4), SUCCESS);
+      r4 = a4;
+    }
+    ck_assert_int_eq(eq_matrix(&c, &product), SUCCESS);
+    ck_assert_int_eq(eq_matrix(&d, &transposed), SUCCESS);
+    ck_assert_double_eq_tol(det, determinant(&a), 1e-7);
+    remove_matrix(&c);
+    c = n == 2 ? mat2_to_matrix(&r2)
+               : (n == 3 ? mat3_to_matrix(&r3) : mat4_to_matrix(&r4));
+    ck_assert_int_eq(eq_matrix(&c, &inverse), SUCCESS);
+    remove_matrix(&a);
+    remove_matrix(&b);
+    remove_matrix(&c);
+    remove_matrix(&d);
+    remove_matrix(&product);
+    remove_matrix(&inverse);
+    remove_matrix(&transposed);
+  }
+}
+END_TEST
+
+START_TEST(fixed_2) {
+  mat3_t a = {{{1, 2, 3}, {2, 4, 6}, {0, 1, 1}}}, b = a;
+  mat4_t c = {{{0}}};
+  matrix_t m = create_matrix(3, 4);
+  ck_assert_int_eq(mat3_inverse(&a, &b), FAILURE);
+  ck_assert_double_eq_tol(b.m[1][1], 4, 1e-7);
+  ck_assert_int_eq(mat4_inverse(&c, &c), FAILURE);
+  ck_assert_int_eq(mat3_from_matrix(&m, &a), FAILURE);
+  ck_assert_int_eq(mat4_from_matrix(&m, NULL), FAILURE);
+  ck_assert_int_eq(mat2_from_matrix(NULL, NULL), FAILURE);
+  m.matrix[0][0] = NAN;
+  ck_assert_int_eq(mat2_from_matrix(&m, NULL), FAILURE);
+  remove_matrix(&m);
+}
+END_TEST
+
+START_TEST(strassen_1) {
+  matrix_t a = create_matrix(67, 65), b = create_matrix(65, 70), classic, fast;
+  matrix_t out = create_matrix(67, 70);
+
+  fill_pattern(&a, 3);
+  fill_pattern(&b, 5);
+  a.matrix_type = b.matrix_type = UNKNOWN_MATRIX;
+  set_matrix_product(PRODUCT_CLASSIC);
+  classic = mult_matrix(&a, &b);
+  // two levels of recursion with odd sizes peeled off on the first one
+  set_matrix_product(PRODUCT_AUTO);
+  set_strassen_cutoff(16);
+  fast = mult_matrix(&a, &b);
+  ck_assert_int_eq(eq_matrix(&classic, &fast), SUCCESS);
+  ck_assert_int_eq(mult_matrix_into(&a, &b, &out), SUCCESS);
+  ck_assert_int_eq(eq_matrix(&classic, &out), SUCCESS);
+  set_strassen_cutoff(0);
+  set_matrix_product(PRODUCT_CLASSIC);
+  remove_matrix(&a);
+  remove_matrix(&b);
+  remove_matrix(&classic);
+  remove_matrix(&fast);
+  remove_matrix(&out);
+}
+END_TEST
+
+START_TEST(strassen_2) {
+  ck_assert_int_eq(get_matrix_product(), PRODUCT_CLASSIC);
+  ck_assert_int_eq(get_strassen_cutoff(), 1024);
+  set_strassen_cutoff(300);
+  ck_assert_int_eq(get_strassen_cutoff(), 300);
+  set_strassen_cutoff(-1);
+  ck_assert_int_eq(get_strassen_cutoff(), 1024);
+  set_matrix_product(PRODUCT_AUTO);
+  ck_assert_int_eq(get_matrix_product(), PRODUCT_AUTO);
+  set_matrix_product(PRODUCT_CLASSIC);
+}
+END_TEST
+
+// A = P * L * U spanning three LU panels, so pivots and trailing updates
+// cross panel borders; det(A) = -3^50 since P reverses 150 rows
+START_TEST(blocked_lu_1) {
+  int n = 150;
+  double error = 0.0;
+  matrix_t l = create_matrix(n, n), u = create_matrix(n, n), a, inverse, id;
+  matrix_t ones = create_matrix(n, 1), b, x;
+  lu_t lu;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < i; j++) {
+      l.matrix[i][j] = ((i * 7 + j * 3) % 11 - 5) / 50.0;
+    }
+    l.matrix[i][i] = 1.0;
+    u.matrix[i][i] = 1.0 + i % 3 * 0.5;
+    for (int j = i + 1; j < n; j++) u.matrix[i][j] = ((i + j) % 5 - 2) / 20.0;
+    ones.matrix[i][0] = 1.0;
+  }
+  a = mult_matrix(&l, &u);
+  for (int i = 0; i < n / 2; i++) {
+    swap_rows(a.matrix[i], a.matrix[n - 1 - i], n);
+  }
+  ck_assert_double_eq_tol(determinant(&a) / -pow(3, 50), 1.0, 1e-9);
+  lu = lu_decompose(&a);
+  ck_assert_double_eq_tol(lu_determinant(&lu) / -pow(3, 50), 1.0, 1e-9);
+  b = mult_matrix(&a, &ones);
+  x = lu_solve(&lu, &b);
+  ck_assert_int_eq(eq_matrix(&x, &ones), SUCCESS);
+  inverse = inverse_matrix(&a);
+  id = mult_matrix(&inverse, &a);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      error = fmax(error, fabs(id.matrix[i][j] - (i == j)));
+    }
+  }
+  ck_assert_double_eq_tol(error, 0.0, 1e-7);
+  remove_lu(&lu);
+  remove_matrix(&l);
+  remove_matrix(&u);
+  remove_matrix(&a);
+  remove_matrix(&ones);
+  remove_matrix(&b);
+  remove_matrix(&x);
+  remove_matrix(&inverse);
+  remove_matrix(&id);
+}
+END_TEST
+
+START_TEST(lu_decompose_1) {
+  double values[4][4] = {
+      {0, 2, 1, 4}, {3, -1, 2, 0}, {1, 1, 1, 1}, {-2, 5, 0, 3}};
+  matrix_t a = create_matrix(4, 4);
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) a.matrix[i][j] = values[i][j];
+  a.matrix_type = CORRECT_MATRIX;
+  lu_t lu = lu_decompose(&a);
+  ck_assert_int_eq(get_matrix_type(&lu.lu), CORRECT_MATRIX);
+  int equal = 1;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      double product = 0;
+      for (int k = 0; k <= i && k <= j; k++) {
+        double l_ik = k == i ? 1.0 : lu.lu.matrix[i][k];
+        product += l_ik * lu.lu.matrix[k][j];
+      }
+      equal = equal && fabs(product - values[lu.pivots[i]][j]) < ACCURACY;
+    }
+  }
+  ck_assert_int_eq(equal, 1);
+  ck_assert_int_eq(fabs(lu_determinant(&lu) - determinant(&a)) < ACCURACY, 1);
+  ck_assert_int_eq(fabs(lu_determinant(&lu) + 3) < ACCURACY, 1);
+  remove_lu(&lu);
+  ck_assert_int_eq(lu.pivots == NULL, 1);
+  remove_matrix(&a);
+}
+END_TEST
+
+START_TEST(lu_decompose_2) {
+  matrix_t a = create_matrix(2, 3);
+  lu_t lu = lu_decompose(&a);
+  ck_assert_int_eq(get_matrix_type(&lu.lu), INCORRECT_MATRIX);
+  fail_if(lu_determinant(&lu) == lu_determinant(&lu));
+  remove_lu(&lu);
+  remove_matrix(&a);
+}
+END_TEST
+
+START_TEST(solve_1) {
+  double values[3][3] = {{2, 1, -1}, {-3, -1, 2}, {-2, 1, 2}};
+  matrix_t a = create_matrix(3, 3), b = create_matrix(3, 2);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) a.matrix[i][j] = values[i][j];
+  b.matrix[0][0] = 8;
+  b.matrix[1][0] = -11;
+  b.matrix[2][0] = -3;
+  b.matrix[0][1] = 2;
+  b.matrix[1][1] = -3;
+  b.matrix[2][1] = -2;
+  a.matrix_type = b.matrix_type = CORRECT_MATRIX;
+  matrix_t x = solve_matrix(&a, &b);
+  ck_assert_int_eq(fabs(x.matrix[0][0] - 2) < ACCURACY, 1);
+  ck_assert_int_eq(fabs(x.matrix[1][0] - 3) < ACCURACY, 1);
+  ck_assert_int_eq(fabs(x.matrix[2][0] + 1) < ACCURACY, 1);
+  ck_assert_int_eq(fabs(x.matrix[0][1] - 1) < ACCURACY, 1);
+  ck_assert_int_eq(fabs(x.matrix[1][1]) < ACCURACY, 1);
+  ck_assert_int_eq(fabs(x.matrix[2][1]) < ACCURACY, 1);
+  remove_matrix(&x);
+  matrix_t singular = create_matrix(3, 3);
+  x = solve_matrix(&singular, &b);
+  ck_assert_int_eq(get_matrix_type(&x), INCORRECT_MATRIX);
+  remove_matrix(&singular);
+  remove_matrix(&a);
+  remove_matrix(&b);
+}
+END_TEST
+
 Suite *matrix_suite(void) {
   Suite *suite;
   TCase *getCase;
@@ -1721,6 +2832,7 @@ Suite *matrix_suite(void) {
   tcase_add_test(getCase, create_1);
   tcase_add_test(getCase, create_2);
   tcase_add_test(getCase, create_3);
+  tcase_add_test(getCase, create_4);
   tcase_add_test(getCase, rem_1);
   tcase_add_test(getCase, eq_1);
   tcase_add_test(getCase, eq_2);
@@ -1733,6 +2845,7 @@ Suite *matrix_suite(void) {
   tcase_add_test(getCase, mult_num_2);
   tcase_add_test(getCase, mult_m_1);
   tcase_add_test(getCase, mult_m_2);
+  tcase_add_test(getCase, mult_m_3);
   tcase_add_test(getCase, trans_1);
   tcase_add_test(getCase, trans_2);
   tcase_add_test(getCase, calc_compl_1);
@@ -1787,6 +2900,41 @@ Suite *matrix_suite(void) {
   tcase_add_test(getCase, inverse_matrix_2);
   tcase_add_test(getCase, inverse_matrix_3);
   tcase_add_test(getCase, inverse_matrix_4);
+  tcase_add_test(getCase, inverse_matrix_5);
+  tcase_add_test(getCase, calc_complements_6);
+  tcase_add_test(getCase, calc_complements_7);
+  tcase_add_test(getCase, simd_kernels_1);
+  tcase_add_test(getCase, lazy_type_1);
+  tcase_add_test(getCase, lazy_type_2);
+  tcase_add_test(getCase, validation_1);
+  tcase_add_test(getCase, into_1);
+  tcase_add_test(getCase, into_2);
+  tcase_add_test(getCase, inplace_1);
+  tcase_add_test(getCase, arena_1);
+  tcase_add_test(getCase, arena_2);
+  tcase_add_test(getCase, cache_1);
+  tcase_add_test(getCase, cache_2);
+  tcase_add_test(getCase, view_1);
+  tcase_add_test(getCase, view_2);
+  tcase_add_test(getCase, transpose_5);
+  tcase_add_test(getCase, view_3);
+  tcase_add_test(getCase, gemm_1);
+  tcase_add_test(getCase, gemm_2);
+  tcase_add_test(getCase, threads_1);
+  tcase_add_test(getCase, threads_2);
+  tcase_add_test(getCase, parallel_1);
+  tcase_add_test(getCase, parallel_2);
+  tcase_add_test(getCase, parallel_3);
+  tcase_add_test(getCase, batch_1);
+  tcase_add_test(getCase, batch_2);
+  tcase_add_test(getCase, fixed_1);
+  tcase_add_test(getCase, fixed_2);
+  tcase_add_test(getCase, strassen_1);
+  tcase_add_test(getCase, strassen_2);
+  tcase_add_test(getCase, blocked_lu_1);
+  tcase_add_test(getCase, lu_decompose_1);
+  tcase_add_test(getCase, lu_decompose_2);
+  tcase_add_test(getCase, solve_1);
 
   suite_add_tcase(suite, getCase);
 
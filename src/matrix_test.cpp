@@ -0,0 +1,279 @@
+#include "matrix.hpp"
+
+#include <check.h>
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "matrix_fixed.hpp"
+
+template <class A, class B, class = void>
+struct Multipliable : std::false_type {};
+
+template <class A, class B>
+struct Multipliable<A, B,
+                    std::void_t<decltype(std::declval<A>() * std::declval<B>())>>
+    : std::true_type {};
+
+static s21::Matrix filled(int rows, int columns, int seed) {
+  s21::Matrix matrix(rows, columns);
+
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < columns; j++) matrix(i, j) = (i * seed + j * 7) % 13;
+  }
+
+  return matrix;
+}
+
+START_TEST(wrapper_1) {
+  s21::Matrix a = filled(3, 3, 3), b = filled(3, 3, 5);
+  matrix_t sum = sum_matrix(a.Get(), b.Get());
+  matrix_t product = mult_matrix(a.Get(), b.Get());
+  matrix_t chained = mult_number(&product, 2.0);
+
+  sum_matrix_inplace(&chained, &sum);
+  ck_assert(a + b == s21::Matrix(sum));
+  ck_assert(a * b == s21::Matrix(product));
+  ck_assert((a * b) * 2.0 + (a + b) == s21::Matrix(chained));
+  ck_assert(a != b);
+  ck_assert_double_eq_tol(a.Determinant(), determinant(a.Get()), 1e-7);
+  ck_assert(a.Transpose().Transpose() == a);
+  s21::Matrix identity(3, 3);
+  for (int i = 0; i < 3; i++) identity(i, i) = 1.0;
+  ck_assert(a * a.Inverse() == identity);
+  ck_assert_int_eq(get_matrix_type(identity.Get()), IDENTITY_MATRIX);
+  identity(0, 1) = 5.0;
+  ck_assert_int_eq(get_matrix_type(identity.Transpose().Get()),
+                   CORRECT_MATRIX);
+  ck_assert(a.Clone() == a);
+  a *= b;
+  ck_assert(a == filled(3, 3, 3) * b);
+  a -= a.Clone();
+  ck_assert_double_eq_tol(a(2, 2), 0.0, 1e-7);
+}
+END_TEST
+
+START_TEST(wrapper_2) {
+  s21::Matrix a = filled(4, 2, 3);
+  const double *data = a.Get()->data;
+  s21::Matrix b(std::move(a));
+  s21::Matrix c;
+
+  ck_assert(a.Empty());
+  ck_assert_ptr_eq(b.Get()->data, data);
+  c = std::move(b);
+  ck_assert(b.Empty());
+  ck_assert_ptr_eq(c.Get()->data, data);
+  // temporaries are updated in place instead of allocating new results
+  s21::Matrix d = std::move(c) * 2.0 + filled(4, 2, 1);
+  ck_assert_ptr_eq(d.Get()->data, data);
+  ck_assert_double_eq_tol(d(1, 1), 2.0 * 10 + 8, 1e-7);
+  matrix_t released = d.Release();
+  ck_assert(d.Empty());
+  ck_assert_ptr_eq(released.data, data);
+  remove_matrix(&released);
+}
+END_TEST
+
+START_TEST(wrapper_3) {
+  s21::Matrix a = filled(2, 3, 3), b = filled(3, 3, 0), empty;
+  int thrown = 0;
+
+  try {
+    s21::Matrix sum = a + b;
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  try {
+    a.Determinant();
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  try {
+    b.Inverse();
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  try {
+    empty *= 2.0;
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  try {
+    a(2, 0) = 1.0;
+  } catch (const std::out_of_range &) {
+    thrown++;
+  }
+  try {
+    s21::Matrix wrong(0, 3);
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  ck_assert_int_eq(thrown, 6);
+}
+END_TEST
+
+START_TEST(expression_1) {
+  s21::Matrix a = filled(5, 7, 3), b = filled(5, 7, 5), c = filled(5, 7, 2);
+  matrix_t scaled = mult_number(a.Get(), 2.0);
+  matrix_t sum = sum_matrix(&scaled, b.Get());
+  s21::Matrix expected(sub_matrix(&sum, c.Get()));
+  s21::Matrix d = 2.0 * a + b - c;
+
+  ck_assert(d == expected);
+  // same-size destination is overwritten in place, even if it is an operand
+  const double *data = d.Get()->data;
+  d = -a + d * 0.5;
+  ck_assert_ptr_eq(d.Get()->data, data);
+  ck_assert_double_eq_tol(d(4, 6), -a(4, 6) + 0.5 * expected(4, 6), 1e-7);
+  d += 2.0 * a;
+  ck_assert_ptr_eq(d.Get()->data, data);
+  ck_assert(d == 0.5 * expected + a);
+  remove_matrix(&scaled);
+  remove_matrix(&sum);
+}
+END_TEST
+
+START_TEST(expression_2) {
+  s21::Matrix a = filled(6, 6, 3), b = filled(6, 6, 5), c = filled(6, 6, 2);
+  matrix_t product = mult_matrix(a.Get(), b.Get());
+  matrix_t scaled = mult_number(&product, 3.0);
+  s21::Matrix expected(sum_matrix(&scaled, c.Get()));
+
+  // product is computed by GEMM before its operand "a" is overwritten
+  a = 3.0 * (a * b) + c;
+  ck_assert(a == expected);
+  ck_assert((a + b) * c.Transpose() ==
+            expected * c.Transpose() + b * c.Transpose());
+  a *= b;
+  ck_assert(a == expected * b);
+  remove_matrix(&product);
+  remove_matrix(&scaled);
+}
+END_TEST
+
+START_TEST(expression_3) {
+  s21::Matrix a = filled(2, 3, 3), b = filled(3, 3, 5), c;
+  int thrown = 0;
+
+  try {
+    static_cast<void>(a + b);
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  try {
+    static_cast<void>(b * a);
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  b(1, 1) = NAN;
+  auto lazy = 2.0 * b;
+  try {
+    c = lazy + b;
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  ck_assert_int_eq(thrown, 3);
+  ck_assert(c.Empty());
+  b(1, 1) = 0.0;
+  c = lazy;
+  ck_assert(c == b * 2.0);
+  ck_assert(c != b);
+}
+END_TEST
+
+START_TEST(fixed_template_1) {
+  using s21::fixed::Matrix;
+  constexpr Matrix<3, 3> a({{2, 5, 7}, {6, 3, 4}, {5, -2, -3}});
+  constexpr Matrix<3, 2> b({{1, 2}, {3, 4}, {5, 6}});
+  constexpr Matrix<4, 4> c({{1, 2, 3, 4}, {5, 0, 7, 8}, {9, 1, 1, 2}, {3, 4, 5, 0}});
+
+  // everything below is computed by the compiler
+  static_assert(a.Determinant() == -1.0);
+  static_assert(a * a.Inverse() == Matrix<3, 3>::Identity());
+  static_assert((a * b)(2, 1) == 10 - 8 - 18);
+  static_assert(b.Transpose()(1, 2) == 6);
+  static_assert(c * c.Inverse() == Matrix<4, 4>::Identity());
+  static_assert(Multipliable<Matrix<3, 3>, Matrix<3, 2>>::value);
+  static_assert(!Multipliable<Matrix<3, 2>, Matrix<3, 2>>::value);
+
+  s21::Matrix heap = c.ToMatrix();
+  ck_assert_double_eq_tol(c.Determinant(), heap.Determinant(), 1e-7);
+  ck_assert(c.Inverse().ToMatrix() == heap.Inverse());
+  ck_assert((Matrix<4, 4>::FromMatrix(heap * heap) == c * c));
+  ck_assert((2.0 * a - a + a * 0.0) == a);
+}
+END_TEST
+
+START_TEST(fixed_template_2) {
+  using s21::fixed::Matrix;
+  Matrix<6, 6> a;
+  Matrix<6, 6, float> b;
+  int thrown = 0;
+
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 6; j++) {
+      a(i, j) = (i * 3 + j * 7) % 13 + (i == j ? 9 : 0);
+      b(i, j) = static_cast<float>(a(i, j));
+    }
+  }
+  s21::Matrix heap = a.ToMatrix();
+  ck_assert_double_eq_tol(a.Determinant() / heap.Determinant(), 1.0, 1e-12);
+  ck_assert(a.Inverse().ToMatrix() == heap.Inverse());
+  ck_assert((a.Inverse() * a == Matrix<6, 6>::Identity()));
+  ck_assert_double_eq_tol(b.Determinant() / a.Determinant(), 1.0, 1e-5);
+  try {
+    Matrix<5, 5>().Inverse();
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  try {
+    Matrix<3, 3>().Inverse();
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  try {
+    Matrix<5, 6>::FromMatrix(heap);
+  } catch (const std::invalid_argument &) {
+    thrown++;
+  }
+  ck_assert_int_eq(thrown, 3);
+}
+END_TEST
+
+Suite *matrix_wrapper_suite(void) {
+  Suite *suite;
+  TCase *getCase;
+
+  suite = suite_create("Matrix C++");
+  getCase = tcase_create("core");
+
+  tcase_add_test(getCase, wrapper_1);
+  tcase_add_test(getCase, wrapper_2);
+  tcase_add_test(getCase, wrapper_3);
+  tcase_add_test(getCase, expression_1);
+  tcase_add_test(getCase, expression_2);
+  tcase_add_test(getCase, expression_3);
+  tcase_add_test(getCase, fixed_template_1);
+  tcase_add_test(getCase, fixed_template_2);
+
+  suite_add_tcase(suite, getCase);
+
+  return suite;
+}
+
+int main(void) {
+  int amountOfFailed = 0;
+  SRunner *runner;
+  Suite *suite;
+
+  suite = matrix_wrapper_suite();
+  runner = srunner_create(suite);
+
+  srunner_run_all(runner, CK_NORMAL);
+  amountOfFailed = srunner_ntests_failed(runner);
+  srunner_free(runner);
+
+  return (amountOfFailed == 0) ? 0 : 1;
+}
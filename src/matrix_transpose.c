@@ -0,0 +1,96 @@
+#include "matrix.h"
+
+// blocks of this size fit L1 as source and destination at once
+#define TRANSPOSE_BLOCK 32
+
+typedef struct transpose_job_struct {
+  const double *a;
+  int lda;
+  double *b;
+  int ldb;
+  int columns;
+} transpose_job_t;
+
+static void transpose_rows_task(void *arg, int begin, int end) {
+  const transpose_job_t *job = (const transpose_job_t *)arg;
+
+  transpose_recursive(job->a + (size_t)begin * job->lda, job->lda,
+                      job->b + begin, job->ldb, end - begin, job->columns);
+}
+
+void transpose_block(const double *a, int lda, double *b, int ldb, int rows,
+                     int columns) {
+  transpose_job_t job = {a, lda, b, ldb, columns};
+  int grain = MATRIX_PARALLEL_GRAIN / columns;
+
+  // stripes of whole blocks keep threads off each other's cache lines
+  grain = (grain / TRANSPOSE_BLOCK + 1) * TRANSPOSE_BLOCK;
+  parallel_for(rows, grain, transpose_rows_task, &job);
+}
+
+void transpose_recursive(const double *a, int lda, double *b, int ldb,
+                         int rows, int columns) {
+  // halving the larger side keeps blocks square-ish at every cache level
+  if (rows <= TRANSPOSE_BLOCK && columns <= TRANSPOSE_BLOCK) {
+    transpose_tile(a, lda, b, ldb, rows, columns);
+  } else if (rows >= columns) {
+    int half = rows / 2;
+    transpose_recursive(a, lda, b, ldb, half, columns);
+    transpose_recursive(a + (size_t)half * lda, lda, b + half, ldb,
+                        rows - half, columns);
+  } else {
+    int half = columns / 2;
+    transpose_recursive(a, lda, b, ldb, rows, half);
+    transpose_recursive(a + half, lda, b + (size_t)half * ldb, ldb, rows,
+                        columns - half);
+  }
+}
+
+void transpose_square(double *a, int n, int lda) {
+  if (n <= TRANSPOSE_BLOCK) {
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) {
+        double upper = a[(size_t)i * lda + j];
+        a[(size_t)i * lda + j] = a[(size_t)j * lda + i];
+        a[(size_t)j * lda + i] = upper;
+      }
+    }
+  } else {
+    int half = n / 2;
+    transpose_square(a, half, lda);
+    transpose_square(a + (size_t)half * lda + half, n - half, lda);
+    swap_transposed(a + half, a + (size_t)half * lda, half, n - half, lda);
+  }
+}
+
+void swap_transposed(double *a, double *b, int rows, int columns, int lda) {
+  if (rows <= TRANSPOSE_BLOCK && columns <= TRANSPOSE_BLOCK) {
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < columns; j++) {
+        double value = a[(size_t)i * lda + j];
+        a[(size_t)i * lda + j] = b[(size_t)j * lda + i];
+        b[(size_t)j * lda + i] = value;
+      }
+    }
+  } else if (rows >= columns) {
+    int half = rows / 2;
+    swap_transposed(a, b, half, columns, lda);
+    swap_transposed(a + (size_t)half * lda, b + half, rows - half, columns,
+                    lda);
+  } else {
+    int half = columns / 2;
+    swap_transposed(a, b, rows, half, lda);
+    swap_transposed(a + half, b + (size_t)half * lda, rows, columns - half,
+                    lda);
+  }
+}
+
+void transpose_tile(const double *restrict a, int lda, double *restrict b,
+                    int ldb, int rows, int columns) {
+  // contiguous writes: strided reads of a small tile stay in L1
+  for (int j = 0; j < columns; j++) {
+    for (int i = 0; i < rows; i++) {
+      b[(size_t)j * ldb + i] = a[(size_t)i * lda + j];
+    }
+  }
+}
@@ -0,0 +1,248 @@
+#include "matrix.h"
+
+matrix_view_t view_matrix(matrix_t *a) {
+  matrix_view_t view;
+
+  view_error(&view);
+  if (a && a->data) {
+    view.origin = a->data;
+    view.rows = a->rows;
+    view.columns = a->columns;
+    view.stride = a->stride;
+  }
+
+  return view;
+}
+
+matrix_view_t view_submatrix(matrix_t *a, int row, int column, int rows,
+                             int columns) {
+  matrix_view_t view;
+
+  view_error(&view);
+  if (a && a->data && row >= 0 && column >= 0 && rows > 0 && columns > 0 &&
+      row + rows <= a->rows && column + columns <= a->columns) {
+    view.origin = a->data + (size_t)row * a->stride + column;
+    view.rows = rows;
+    view.columns = columns;
+    view.stride = a->stride;
+  }
+
+  return view;
+}
+
+matrix_view_t view_minor(matrix_t *a, int row, int column) {
+  matrix_view_t view;
+
+  view_error(&view);
+  if (a && a->data && a->rows > 1 && a->columns > 1 && row >= 0 &&
+      column >= 0 && row < a->rows && column < a->columns) {
+    view.origin = a->data;
+    view.rows = a->rows - 1;
+    view.columns = a->columns - 1;
+    view.stride = a->stride;
+    view.skip_row = row;
+    view.skip_column = column;
+  }
+
+  return view;
+}
+
+int eq_matrix_view(matrix_view_t a, matrix_view_t b) {
+  char state = 0;
+
+  state = check_view(a) && check_view(b) && a.rows == b.rows &&
+          a.columns == b.columns;
+  for (int i = 0; state && i < a.rows; i++) {
+    for (int j = 0; state && j < a.columns; j++) {
+      state = fabs(view_element(a, i, j) - view_element(b, i, j)) < ACCURACY;
+    }
+  }
+
+  return state ? SUCCESS : FAILURE;
+}
+
+double determinant_view(matrix_view_t a) {
+  double returnable = NAN;
+
+  if (check_view(a) && a.rows == a.columns) {
+    returnable = calculate_view_determinant(a);
+  }
+
+  return returnable;
+}
+
+matrix_t mult_matrix_view(matrix_view_t a, matrix_view_t b) {
+  matrix_arena_mark_t mark = arena_mark(matrix_scratch());
+  matrix_t matrix;
+
+  if (check_view(a) && check_view(b) && a.columns == b.rows) {
+    matrix = allocate_matrix(get_matrix_arena(), a.rows, b.columns);
+    // skipped row or column breaks constant stride, so such views are packed
+    if (matrix.matrix && (!view_is_strided(a) || !view_is_strided(b))) {
+      a = pack_view(a);
+      b = pack_view(b);
+    }
+    if (matrix.matrix && a.origin && b.origin) {
+      // transposed views swap row and column strides
+      int rsa = a.transposed ? 1 : a.stride, csa = a.transposed ? a.stride : 1;
+      int rsb = b.transposed ? 1 : b.stride, csb = b.transposed ? b.stride : 1;
+      if (!gemm_blocked(a.rows, b.columns, a.columns, 1.0, a.origin, rsa, csa,
+                        b.origin, rsb, csb, 0.0, matrix.data, matrix.stride)) {
+        remove_matrix(&matrix);
+        matrix_error(&matrix);
+      }
+    } else {
+      remove_matrix(&matrix);
+      matrix_error(&matrix);
+    }
+  } else {
+    matrix_error(&matrix);
+  }
+  arena_reset(matrix_scratch(), mark);
+
+  return matrix;
+}
+
+matrix_t transpose_view(matrix_view_t a) {
+  matrix_t matrix;
+
+  if (check_view(a)) {
+    matrix = allocate_matrix(get_matrix_arena(), a.columns, a.rows);
+    if (matrix.matrix) {
+      copy_view(view_transposed(a), matrix.data, matrix.stride);
+    }
+  } else {
+    matrix_error(&matrix);
+  }
+
+  return matrix;
+}
+
+matrix_view_t view_transposed(matrix_view_t a) {
+  matrix_view_t view = a;
+
+  view.rows = a.columns;
+  view.columns = a.rows;
+  view.skip_row = a.skip_column;
+  view.skip_column = a.skip_row;
+  view.transposed = !a.transposed;
+
+  return view;
+}
+
+void view_error(matrix_view_t *view) {
+  view->origin = NULL;
+  view->rows = 0;
+  view->columns = 0;
+  view->stride = 0;
+  view->skip_row = -1;
+  view->skip_column = -1;
+  view->transposed = 0;
+}
+
+char check_view(matrix_view_t a) {
+  matrix_validation_t policy = get_matrix_validation();
+  char state = a.origin != NULL && a.rows > 0 && a.columns > 0;
+
+#ifdef NDEBUG
+  if (policy == VALIDATION_DEBUG) policy = VALIDATION_TRUSTED;
+#endif
+  // views have no place to cache scan result, so CACHED scans every time
+  for (int i = 0; state && policy != VALIDATION_TRUSTED && i < a.rows; i++) {
+    for (int j = 0; state && j < a.columns; j++) {
+      state = view_element(a, i, j) == view_element(a, i, j);
+    }
+  }
+
+  return state;
+}
+
+double view_element(matrix_view_t a, int i, int j) {
+  if (a.skip_row >= 0 && i >= a.skip_row) i++;
+  if (a.skip_column >= 0 && j >= a.skip_column) j++;
+
+  return a.transposed ? a.origin[(size_t)j * a.stride + i]
+                      : a.origin[(size_t)i * a.stride + j];
+}
+
+char view_is_strided(matrix_view_t a) {
+  return a.skip_row < 0 && a.skip_column < 0;
+}
+
+void copy_view(matrix_view_t a, double *dst, int ld) {
+  if (view_is_strided(a) && a.transposed) {
+    transpose_block(a.origin, a.stride, dst, ld, a.columns, a.rows);
+  } else if (view_is_strided(a)) {
+    for (int i = 0; i < a.rows; i++) {
+      memcpy(dst + (size_t)i * ld, a.origin + (size_t)i * a.stride,
+             sizeof(double) * a.columns);
+    }
+  } else {
+    for (int i = 0; i < a.rows; i++) {
+      for (int j = 0; j < a.columns; j++) {
+        dst[(size_t)i * ld + j] = view_element(a, i, j);
+      }
+    }
+  }
+}
+
+matrix_view_t pack_view(matrix_view_t a) {
+  matrix_view_t view = a;
+  double *packed = NULL;
+
+  if (!view_is_strided(a)) {
+    packed = (double *)arena_alloc(matrix_scratch(),
+                                   matrix_data_size(a.rows, a.columns));
+    view_error(&view);
+    if (packed) {
+      copy_view(a, packed, a.columns);
+      view.origin = packed;
+      view.rows = a.rows;
+      view.columns = a.columns;
+      view.stride = a.columns;
+    }
+  }
+
+  return view;
+}
+
+double calculate_view_determinant(matrix_view_t a) {
+  double returnable = NAN, m[3][3];
+
+  if (a.rows <= 3) {
+    copy_view(a, m[0], 3);
+  }
+  if (a.rows == 1) {
+    returnable = m[0][0];
+  } else if (a.rows == 2) {
+    returnable = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+  } else if (a.rows == 3) {
+    returnable = m[0][0] * (m[1][1] * m[2][2] - m[2][1] * m[1][2]) -
+                 m[0][1] * (m[1][0] * m[2][2] - m[2][0] * m[1][2]) +
+                 m[0][2] * (m[1][0] * m[2][1] - m[2][0] * m[1][1]);
+  } else if (a.rows > 3) {
+    returnable = calculate_Gauss_determinant_view(a);
+  }
+
+  return returnable;
+}
+
+double calculate_Gauss_determinant_view(matrix_view_t a) {
+  int n = a.rows, sign = 1;
+  size_t data_size = matrix_data_size(n, n);
+  double returnable = NAN, *scratch = NULL;
+  matrix_arena_mark_t mark = arena_mark(matrix_scratch());
+
+  scratch = (double *)arena_alloc(matrix_scratch(),
+                                  data_size + matrix_rows_size(n));
+  if (scratch) {
+    copy_view(a, scratch, n);
+    if (lu_factor_blocked(scratch, n, n, (int *)((char *)scratch + data_size),
+                          &sign)) {
+      returnable = lu_diagonal_product(scratch, n, n, sign);
+    }
+  }
+  arena_reset(matrix_scratch(), mark);
+
+  return returnable;
+}